@@ -1,275 +1,374 @@
-#include "xparameters.h"
-#include "xil_io.h"
-#include "xil_printf.h"
-#include <stdint.h>
+#include "mont_hal.h"
+#include "mont_sw.h"
 
 /* -------------------------------------------------------------------------- */
-/* Hardware configuration                                                     */
+/* Configuration                                                              */
+/*   Accelerator base addresses and the register map live in mont_hal.[ch].  */
 /* -------------------------------------------------------------------------- */
 
-/* 2048-bit Montgomery accelerator (original core) */
-#define MONT2048_BASE   XPAR_MONTGOMERY_AXI_0_BASEADDR
-
-/* 1024-bit Montgomery accelerator (new 1024-bit IP block) */
-/* If your IP name is different, adjust this macro, e.g.:
- *   #define MONT1024_BASE  XPAR_MONTGOMERY_AXI_1024_0_BASEADDR
- */
-#define MONT1024_BASE   XPAR_MONTGOMERY_AXI_1024_0_BASEADDR
-
-/* AXI register layout – must match both AXI wrappers */
-#define REG_A(base,i)       ((base) + 0x000U + 4U*(i))
-#define REG_B(base,i)       ((base) + 0x200U + 4U*(i))
-#define REG_N(base,i)       ((base) + 0x400U + 4U*(i))
-#define REG_RES(base,i)     ((base) + 0x600U + 4U*(i))
-#define REG_NPRIME(base)    ((base) + 0x800U)
-#define REG_CONTROL(base)   ((base) + 0x804U)
-#define REG_STATUS(base)    ((base) + 0x808U)
-
-/* word sizes */
-#define NWORDS_1024     32U        /* 1024 / 32 */
-#define NWORDS_2048     64U        /* 2048 / 32 */
-#define MAX_WORDS       NWORDS_2048
-
-/* benchmark runs per case */
+/* benchmark runs per case (override with -DNUM_RUNS=n for slow backends) */
+#ifndef NUM_RUNS
 #define NUM_RUNS        32U
+#endif
 
-/* max polls for HW done (prevents infinite hang) */
-#define HW_DONE_TIMEOUT 100000000U
-
-typedef uint32_t u32;
-typedef uint64_t u64;
-
-/* -------------------------------------------------------------------------- */
-/* Global timer (Zynq ARM generic timer)                                      */
-/* -------------------------------------------------------------------------- */
+/* independent products per stream benchmark */
+#define STREAM_LEN      16U
 
-#define GTIMER_BASE     0xF8F00200U
-#define GTIMER_CTRL     (GTIMER_BASE + 0x08U)
+/* descriptor ring entries (fewer than STREAM_LEN, so the ring wraps; more
+ * than the 2 * NUM_LANES operand banks the core can keep busy) */
+#define RING_LEN        12U
 
-/* Approximate frequency in Hz (adjust if you know exact value) */
-#define GTIMER_FREQ_HZ  650000000U
+/* products in the ring throughput run (the STREAM_LEN jobs, repeated) */
+#define RING_RUN_LEN    (4U * STREAM_LEN)
 
-static void Timer_Init(void)
-{
-    /* enable global timer (bit 0 = EN) */
-    u32 ctrl = Xil_In32(GTIMER_CTRL);
-    ctrl |= 0x1U;
-    Xil_Out32(GTIMER_CTRL, ctrl);
-
-    xil_printf("[INFO] Global timer enabled, freq ~%u Hz\r\n",
-               (unsigned)GTIMER_FREQ_HZ);
-}
-
-static inline u64 Timer_GetCount(void)
-{
-    u32 low, high0, high1;
-    do {
-        high0 = Xil_In32(GTIMER_BASE + 0x04U);
-        low   = Xil_In32(GTIMER_BASE + 0x00U);
-        high1 = Xil_In32(GTIMER_BASE + 0x04U);
-    } while (high0 != high1);
-    return ((u64)high1 << 32) | (u64)low;
-}
+/* max polls for HW done (prevents infinite hang) */
+#define HW_DONE_TIMEOUT 100000000U
 
-static inline u64 Timer_Delta(u64 start, u64 end)
-{
-    if (end >= start) return end - start;
-    return (0xFFFFFFFFFFFFFFFFULL - start) + 1ULL + end;
-}
+/* STATUS polls before a wait sleeps on the done interrupt, about one
+ * 1024-bit product on the radix-2 core; ~0U keeps pure polling */
+#ifndef HW_SPIN_POLLS
+#define HW_SPIN_POLLS   256U
+#endif
 
 /* -------------------------------------------------------------------------- */
 /* Toy RSA key (same for both sizes – padded with zeros)                     */
-/*   n = 3233, e = 17, d = 2753                                              */
+/*   n = 61 * 53 = 3233, lambda(n) = lcm(60, 52) = 780, d = 2753            */
+/*   e = 65537 (= 17 mod 780). The benchmarks use d + k * lambda(n) for a    */
+/*   random k, so the private exponent is as long as the key and about half */
+/*   ones, like a real one; the results stay those of d = 2753.             */
 /* -------------------------------------------------------------------------- */
 
 static u32 RSA_N[MAX_WORDS] = {
     3233U, 0U   /* remaining elements auto-zeroed */
 };
 
-#define RSA_E           17U
-#define RSA_E_BITS      5       /* 17 = 0b10001 */
+#define RSA_E           65537U
 #define RSA_D           2753U
-#define RSA_D_BITS      12
+#define RSA_LAMBDA      780U
+
+/* CRT form: p, q, dp = d mod (p-1), dq = d mod (q-1), qinv = q^-1 mod p */
+static u32 RSA_P[MAX_WORDS]    = { 61U, 0U };
+static u32 RSA_Q[MAX_WORDS]    = { 53U, 0U };
+static u32 RSA_QINV[MAX_WORDS] = { 38U, 0U };
+
+#define RSA_DP          53U
+#define RSA_DQ          49U
 
 /* example plaintext m < n, padded */
 static const u32 RSA_MSG[MAX_WORDS] = {
     42U, 0U
 };
 
-/* R^2 mod n for each size (Montgomery) */
-static u32 RSA_R2_1024[MAX_WORDS];
-static u32 RSA_R2_2048[MAX_WORDS];
+/* public exponent, and the private one stretched to each key size */
+static mont_exp_t RSA_E_EXP;
+static mont_exp_t RSA_D_1024;
+static mont_exp_t RSA_D_2048;
 
-/* Montgomery n' = -n^{-1} mod 2^32 (per size; same numeric value) */
-static u32 NPRIME_1024;
-static u32 NPRIME_2048;
+/* CRT halves of the RSA-2048 key: 1024-bit dp / dq */
+static mont_exp_t RSA_DP_1024;
+static mont_exp_t RSA_DQ_1024;
 
 /* -------------------------------------------------------------------------- */
-/* Big-integer helpers                                                        */
+/* HW Montgomery wrapper (with timeout)                                      */
+/*   N and n' come from the key slot made current by mont_hal_key_load().    */
 /* -------------------------------------------------------------------------- */
 
-static void bigint_copy(u32 *dst, const u32 *src, u32 nwords)
+static int montgomery_mul_hw(mont_dev_t *dev,
+                             u32 nwords,
+                             const u32 *A,
+                             const u32 *B,
+                             u32 *R,
+                             const char *label)
 {
-    for (u32 i = 0; i < nwords; ++i)
-        dst[i] = src[i];
+    mont_hal_write_block(dev, REG_A(0), A, nwords);
+    mont_hal_write_block(dev, REG_B(0), B, nwords);
+
+    mont_hal_start(dev);
+
+    if (!mont_hal_wait_done(dev, HW_DONE_TIMEOUT)) {
+        xil_printf("[ERROR] HW timeout in montgomery_mul_hw for %s (%s, base 0x%08lx)\r\n",
+                   label, dev->backend, (unsigned long)dev->base);
+        return 0;
+    }
+
+    mont_hal_read_block(dev, REG_RES(0), R, nwords);
+
+    return 1;
 }
 
-static void bigint_set_u32(u32 *dst, u32 v, u32 nwords)
+/* -------------------------------------------------------------------------- */
+/* Montgomery / RSA setup                                                     */
+/* -------------------------------------------------------------------------- */
+
+/* out = d + k * lambda with a random k, bits long: the top bit set, the one
+ * below clear so that adding or subtracting less than lambda keeps the
+ * length. Any exponent congruent to d mod lambda(n) gives the same result. */
+static void rsa_exp_stretch(mont_exp_t *out, u32 d, u32 lambda, u32 bits,
+                            u32 seed)
 {
-    dst[0] = v;
-    for (u32 i = 1; i < nwords; ++i)
-        dst[i] = 0U;
+    u32 nw = (bits + 31U) / 32U;
+    u32 x = seed;
+    u64 r = 0ULL;
+    u32 i;
+
+    bigint_set_u32(out->w, 0U, MAX_WORDS);
+    for (i = 0; i < nw; ++i) {
+        x ^= x << 13;                       /* xorshift32 */
+        x ^= x >> 17;
+        x ^= x << 5;
+        out->w[i] = x;
+    }
+    if (bits % 32U != 0U)
+        out->w[nw - 1U] &= (1U << (bits % 32U)) - 1U;
+    out->w[(bits - 1U) / 32U] |=  1U << ((bits - 1U) % 32U);
+    out->w[(bits - 2U) / 32U] &= ~(1U << ((bits - 2U) % 32U));
+
+    for (i = nw; i-- > 0; )                 /* r = out mod lambda */
+        r = ((r << 32) | out->w[i]) % lambda;
+
+    /* out += d - r */
+    if (d >= (u32)r) {
+        u64 carry = d - (u32)r;
+        for (i = 0; i < nw && carry != 0ULL; ++i) {
+            carry += out->w[i];
+            out->w[i] = (u32)carry;
+            carry >>= 32;
+        }
+    } else {
+        u64 borrow = (u32)r - d;
+        for (i = 0; i < nw && borrow != 0ULL; ++i) {
+            u64 t = (u64)out->w[i] - borrow;
+            out->w[i] = (u32)t;
+            borrow = (t >> 63) & 1ULL;
+        }
+    }
+    out->bits = bits;
 }
 
-static int bigint_equal(const u32 *a, const u32 *b, u32 nwords)
+/* HW modular exponentiation (right-to-left square-and-multiply) */
+static int modexp_hw_scalar(mont_dev_t *dev,
+                            const u32 *base,
+                            const mont_exp_t *exp,
+                            const u32 *N,
+                            u32 nprime,
+                            const u32 *R2,
+                            u32 *result,
+                            u32 nwords,
+                            const char *label)
 {
-    for (u32 i = 0; i < nwords; ++i)
-        if (a[i] != b[i])
-            return 0;
+    u32 one[MAX_WORDS];
+    u32 x[MAX_WORDS];
+    u32 a[MAX_WORDS];
+    u32 bit;
+    int ok;
+
+    bigint_set_u32(one, 1U, nwords);
+    mont_hal_key_load(dev, nwords, N, R2, nprime, bigint_bits(N, nwords));
+
+    ok = montgomery_mul_hw(dev, nwords, one,  R2, x, label);
+    if (!ok) return 0;
+    ok = montgomery_mul_hw(dev, nwords, base, R2, a, label);
+    if (!ok) return 0;
+
+    for (bit = 0; bit < exp->bits; ++bit) {
+        if (mont_exp_bit(exp, bit)) {
+            ok = montgomery_mul_hw(dev, nwords, x, a, x, label);
+            if (!ok) return 0;
+        }
+        ok = montgomery_mul_hw(dev, nwords, a, a, a, label);
+        if (!ok) return 0;
+    }
+
+    ok = montgomery_mul_hw(dev, nwords, x, one, result, label);
+    if (!ok) return 0;
+
     return 1;
 }
 
-/* simple software (reference) modular multiply: R = (A * B) mod N */
-static void modmul_sw(const u32 *A, const u32 *B, const u32 *N, u32 *R, u32 nwords)
+/* HW modular exponentiation on the montgomery_axi sequencer:
+ * base and exponent go over the bus once (N, R^2 and n' only on a key slot
+ * miss), one poll for the result. _start / _finish let a caller feed
+ * another core while this one runs. */
+static void modexp_hw_seq_start(mont_dev_t *dev,
+                                const u32 *base,
+                                const mont_exp_t *exp,
+                                const u32 *N,
+                                u32 nprime,
+                                const u32 *R2,
+                                u32 nwords)
 {
-    u64 tmp[2 * MAX_WORDS];
-    u32 i, j;
-
-    for (i = 0; i < 2U * nwords; ++i)
-        tmp[i] = 0ULL;
-
-    for (i = 0; i < nwords; ++i) {
-        u64 carry = 0ULL;
-        for (j = 0; j < nwords; ++j) {
-            u64 t = tmp[i + j] + (u64)A[i] * (u64)B[j] + carry;
-            tmp[i + j] = (u32)t;
-            carry = t >> 32;
-        }
-        tmp[i + nwords] += carry;
-    }
+    mont_hal_key_load(dev, nwords, N, R2, nprime, bigint_bits(N, nwords));
 
-    for (i = 0; i < nwords; ++i)
-        R[i] = (u32)tmp[i];
+    mont_hal_write_block(dev, REG_A(0), base, nwords);
+    mont_hal_write_block(dev, REG_EXP(0), exp->w, (exp->bits + 31U) / 32U);
+    mont_hal_write_reg(dev, REG_EXP_BITS, exp->bits);
 
-    for (;;) {
-        int ge = 0;
-        for (i = nwords; i > 0; ) {
-            --i;
-            if (R[i] > N[i]) { ge = 1; break; }
-            if (R[i] < N[i]) { ge = 0; break; }
-        }
-        if (!ge) break;
+    mont_hal_control(dev, CONTROL_START | CONTROL_MODEXP);
+}
 
-        u64 borrow = 0ULL;
-        for (i = 0; i < nwords; ++i) {
-            u64 t = (u64)R[i] - (u64)N[i] - borrow;
-            R[i] = (u32)t;
-            borrow = (t >> 63) & 1ULL;
-        }
+static int modexp_hw_seq_finish(mont_dev_t *dev,
+                                u32 *result,
+                                u32 nwords,
+                                const char *label)
+{
+    if (!mont_hal_wait_done(dev, HW_DONE_TIMEOUT)) {
+        xil_printf("[ERROR] HW timeout in modexp_hw_seq for %s (%s, base 0x%08lx)\r\n",
+                   label, dev->backend, (unsigned long)dev->base);
+        return 0;
     }
+
+    mont_hal_read_block(dev, REG_RES(0), result, nwords);
+
+    return 1;
 }
 
-/* -------------------------------------------------------------------------- */
-/* HW Montgomery wrapper (with timeout)                                      */
-/* -------------------------------------------------------------------------- */
+static int modexp_hw_seq(mont_dev_t *dev,
+                         const u32 *base,
+                         const mont_exp_t *exp,
+                         const u32 *N,
+                         u32 nprime,
+                         const u32 *R2,
+                         u32 *result,
+                         u32 nwords,
+                         const char *label)
+{
+    modexp_hw_seq_start(dev, base, exp, N, nprime, R2, nwords);
+    return modexp_hw_seq_finish(dev, result, nwords, label);
+}
 
-static int montgomery_mul_hw(u32 base_addr,
-                             u32 nwords,
-                             const u32 *A,
-                             const u32 *B,
-                             const u32 *N,
-                             u32 nprime,
-                             u32 *R,
+/* One plain product with forwarded operands (CONTROL.asrc / bsrc / dst) */
+static int montgomery_fwd_hw(mont_dev_t *dev, u32 asrc, u32 bsrc, u32 dst,
                              const char *label)
 {
-    u32 i;
+    mont_hal_control(dev, CONTROL_START | CONTROL_ASRC(asrc) |
+                          CONTROL_BSRC(bsrc) | CONTROL_DST(dst));
 
-    for (i = 0; i < nwords; ++i) {
-        Xil_Out32(REG_A(base_addr, i), A[i]);
-        Xil_Out32(REG_B(base_addr, i), B[i]);
-        Xil_Out32(REG_N(base_addr, i), N[i]);
+    if (!mont_hal_wait_done(dev, HW_DONE_TIMEOUT)) {
+        xil_printf("[ERROR] HW timeout in montgomery_fwd_hw for %s (%s, base 0x%08lx)\r\n",
+                   label, dev->backend, (unsigned long)dev->base);
+        return 0;
     }
+    return 1;
+}
+
+/* HW modular exponentiation scheduled by the CPU, but with x and a kept in
+ * X0 / X1: only the base goes in and the result comes out over the bus,
+ * every product in between is a CONTROL write and a poll. */
+static int modexp_hw_fwd(mont_dev_t *dev,
+                         const u32 *base,
+                         const mont_exp_t *exp,
+                         const u32 *N,
+                         u32 nprime,
+                         const u32 *R2,
+                         u32 *result,
+                         u32 nwords,
+                         const char *label)
+{
+    u32 bit;
+
+    mont_hal_key_load(dev, nwords, N, R2, nprime, bigint_bits(N, nwords));
+    mont_hal_write_block(dev, REG_A(0), base, nwords);
 
-    Xil_Out32(REG_NPRIME(base_addr), nprime);
-    Xil_Out32(REG_CONTROL(base_addr), 1U);      /* start */
+    /* x = R mod N, a = base * R mod N */
+    if (!montgomery_fwd_hw(dev, MONT_SRC_ONE, MONT_SRC_R2, MONT_DST_X0, label)) return 0;
+    if (!montgomery_fwd_hw(dev, MONT_SRC_MEM, MONT_SRC_R2, MONT_DST_X1, label)) return 0;
 
-    u32 polls = 0;
-    while ((Xil_In32(REG_STATUS(base_addr)) & 0x1U) == 0U) {
-        if (++polls > HW_DONE_TIMEOUT) {
-            xil_printf("[ERROR] HW timeout in montgomery_mul_hw for %s (base 0x%08lx)\r\n",
-                       label, (unsigned long)base_addr);
+    for (bit = 0; bit < exp->bits; ++bit) {
+        if (mont_exp_bit(exp, bit) &&
+            !montgomery_fwd_hw(dev, MONT_SRC_X0, MONT_SRC_X1, MONT_DST_X0, label))
+            return 0;
+        if (bit + 1U < exp->bits &&
+            !montgomery_fwd_hw(dev, MONT_SRC_X1, MONT_SRC_X1, MONT_DST_X1, label))
             return 0;
-        }
     }
 
-    for (i = 0; i < nwords; ++i)
-        R[i] = Xil_In32(REG_RES(base_addr, i));
+    if (!montgomery_fwd_hw(dev, MONT_SRC_X0, MONT_SRC_ONE, MONT_DST_NONE, label)) return 0;
+
+    mont_hal_read_block(dev, REG_RES(0), result, nwords);
 
     return 1;
 }
 
-/* -------------------------------------------------------------------------- */
-/* Montgomery / RSA setup                                                     */
-/* -------------------------------------------------------------------------- */
-
-/* inverse of n modulo 2^32 (n must be odd) */
-static u32 modinv32(u32 n)
+/* SW modular exponentiation (right-to-left square-and-multiply)
+ * Mirrors modexp_hw_scalar step for step, with montgomery_mul_sw in place
+ * of the accelerator, so SW/HW cycle counts compare like for like. */
+static void modexp_sw_scalar(const u32 *base,
+                             const mont_exp_t *exp,
+                             const u32 *N,
+                             u32 nprime,
+                             const u32 *R2,
+                             u32 *result,
+                             u32 nwords)
 {
-    int64_t t = 0, new_t = 1;
-    int64_t r = (int64_t)(1ULL << 32), new_r = n;
+    u32 one[MAX_WORDS];
+    u32 x[MAX_WORDS];
+    u32 a[MAX_WORDS];
+    u32 bit;
 
-    while (new_r != 0) {
-        int64_t q = r / new_r;
-        int64_t tmp;
+    bigint_set_u32(one, 1U, nwords);
 
-        tmp = new_t;
-        new_t = t - q * new_t;
-        t = tmp;
+    montgomery_mul_sw(nwords, one,  R2, N, nprime, x);     /* x = R mod N  */
+    montgomery_mul_sw(nwords, base, R2, N, nprime, a);     /* a = base * R */
 
-        tmp = new_r;
-        new_r = r - q * new_r;
-        r = tmp;
+    for (bit = 0; bit < exp->bits; ++bit) {
+        if (mont_exp_bit(exp, bit))
+            montgomery_mul_sw(nwords, x, a, N, nprime, x);
+        montgomery_mul_sw(nwords, a, a, N, nprime, a);
     }
 
-    if (t < 0)
-        t += ((int64_t)1 << 32);
-
-    return (u32)t;
+    montgomery_mul_sw(nwords, x, one, N, nprime, result);  /* leave Montgomery domain */
 }
 
-/* compute 32-bit R^2 mod n, where R = 2^(32*nwords) (toy 32-bit modulus) */
-static u32 compute_R2_modN_32(u32 n0, u32 nwords)
-{
-    u64 r = 1ULL;
-    u32 total_bits = 32U * nwords;
+/* -------------------------------------------------------------------------- */
+/* Sliding-window exponentiation (modexp_window in mont_sw.c)                 */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    const u32 *N;
+    u32        nprime;
+    u32        nwords;
+} sw_mul_ctx_t;
 
-    for (u32 i = 0; i < total_bits; ++i)
-        r = (r * 2ULL) % (u64)n0;
+typedef struct {
+    mont_dev_t *dev;
+    u32         nwords;
+    const char *label;
+} hw_mul_ctx_t;
 
-    r = (r * r) % (u64)n0;
-    return (u32)r;
+static int mont_mul_sw_fn(void *ctx, const u32 *A, const u32 *B, u32 *R)
+{
+    sw_mul_ctx_t *c = (sw_mul_ctx_t *)ctx;
+
+    montgomery_mul_sw(c->nwords, A, B, c->N, c->nprime, R);
+    return 1;
 }
 
-/* Fill R2_out[] and nprime_out for a given word size */
-static void init_mont_params_for_size(u32 nwords, u32 *R2_out, u32 *nprime_out)
+static int mont_mul_hw_fn(void *ctx, const u32 *A, const u32 *B, u32 *R)
 {
-    u32 n0 = RSA_N[0];
-    u32 inv = modinv32(n0);
-    u32 nprime = (u32)(0U - inv);          /* n' = -n^{-1} mod 2^32 */
-    u32 r2 = compute_R2_modN_32(n0, nwords);
+    hw_mul_ctx_t *c = (hw_mul_ctx_t *)ctx;
 
-    for (u32 i = 0; i < nwords; ++i)
-        R2_out[i] = 0U;
-    R2_out[0] = r2;
+    return montgomery_mul_hw(c->dev, c->nwords, A, B, R, c->label);
+}
+
+/* SW modular exponentiation, sliding window */
+static void modexp_sw_window(const u32 *base,
+                             const mont_exp_t *exp,
+                             const u32 *N,
+                             u32 nprime,
+                             const u32 *R2,
+                             u32 *result,
+                             u32 nwords)
+{
+    sw_mul_ctx_t c = { N, nprime, nwords };
 
-    *nprime_out = nprime;
+    (void)modexp_window(mont_mul_sw_fn, &c, nwords, base, exp, R2, result);
 }
 
-/* HW modular exponentiation (square-and-multiply, scalar exponent) */
-static int modexp_hw_scalar(u32 base_addr,
+/* HW modular exponentiation, sliding window: the CPU walks the exponent and
+ * issues one montgomery_mul_hw call per product, like modexp_hw_scalar */
+static int modexp_hw_window(mont_dev_t *dev,
                             const u32 *base,
-                            u32 exp,
-                            int exp_bits,
+                            const mont_exp_t *exp,
                             const u32 *N,
                             u32 nprime,
                             const u32 *R2,
@@ -277,58 +376,117 @@ static int modexp_hw_scalar(u32 base_addr,
                             u32 nwords,
                             const char *label)
 {
-    u32 one[MAX_WORDS];
-    u32 x[MAX_WORDS];
-    u32 a[MAX_WORDS];
-    int bit;
-    int ok;
+    hw_mul_ctx_t c = { dev, nwords, label };
 
-    bigint_set_u32(one, 1U, nwords);
+    mont_hal_key_load(dev, nwords, N, R2, nprime, bigint_bits(N, nwords));
 
-    ok = montgomery_mul_hw(base_addr, nwords, one,  R2,  N, nprime, x, label);
-    if (!ok) return 0;
-    ok = montgomery_mul_hw(base_addr, nwords, base, R2,  N, nprime, a, label);
-    if (!ok) return 0;
+    return modexp_window(mont_mul_hw_fn, &c, nwords, base, exp, R2, result);
+}
 
-    for (bit = 0; bit < exp_bits; ++bit) {
-        if ((exp >> bit) & 1U) {
-            ok = montgomery_mul_hw(base_addr, nwords, x, a, N, nprime, x, label);
-            if (!ok) return 0;
-        }
-        ok = montgomery_mul_hw(base_addr, nwords, a, a, N, nprime, a, label);
-        if (!ok) return 0;
-    }
+/* -------------------------------------------------------------------------- */
+/* RSA private-key operation with the CRT                                     */
+/*   m1 = c^dp mod p and m2 = c^dq mod q are half-size exponentiations with   */
+/*   half-size exponents; Garner recombines them in software:                */
+/*   m = m2 + q * (qinv * (m1 - m2) mod p).                                  */
+/* -------------------------------------------------------------------------- */
 
-    ok = montgomery_mul_hw(base_addr, nwords, x, one, N, nprime, result, label);
-    if (!ok) return 0;
+typedef struct {
+    u32               nwords;       /* words of p and q (half the key) */
+    const mont_ctx_t *p;            /* p and q with their R mod, R^2 mod, n' */
+    const mont_ctx_t *q;
+    const mont_exp_t *dp;           /* d mod (p-1) */
+    const mont_exp_t *dq;           /* d mod (q-1) */
+    const u32        *qinv;         /* q^-1 mod p */
+} rsa_crt_key_t;
+
+/* m (2 * k->nwords words) from m1 = m mod p and m2 = m mod q */
+static void rsa_crt_garner(const rsa_crt_key_t *k, const u32 *m1,
+                           const u32 *m2, u32 *m)
+{
+    u32 hw = k->nwords;
+    u32 t[MAX_WORDS];
+    u32 h[MAX_WORDS];
+    u32 m2x[MAX_WORDS];
+
+    /* t = (m1 - m2) mod p */
+    bigint_mod(t, m2, hw, k->p->n, hw);
+    if (bigint_sub(t, m1, t, hw))
+        (void)bigint_add(t, t, k->p->n, hw);
+
+    /* h = qinv * t mod p */
+    bigint_mul(m, t, hw, k->qinv, hw);
+    bigint_mod(h, m, 2U * hw, k->p->n, hw);
+
+    /* m = m2 + h * q (< p * q, no carry out) */
+    bigint_mul(m, h, hw, k->q->n, hw);
+    bigint_copy(m2x, m2, hw);
+    bigint_set_u32(m2x + hw, 0U, hw);
+    (void)bigint_add(m, m, m2x, 2U * hw);
+}
+
+/* m = c^d mod pq (c: 2 * k->nwords words), both halves on dev's
+ * sequencer. p and q take one key slot each, so after the first call
+ * neither is uploaded again. */
+static int rsa_decrypt_crt_hw(mont_dev_t *dev, const rsa_crt_key_t *k,
+                              const u32 *c, u32 *m, const char *label)
+{
+    u32 cp[MAX_WORDS], cq[MAX_WORDS];
+    u32 m1[MAX_WORDS], m2[MAX_WORDS];
 
+    bigint_mod(cp, c, 2U * k->nwords, k->p->n, k->nwords);
+    bigint_mod(cq, c, 2U * k->nwords, k->q->n, k->nwords);
+
+    if (!modexp_hw_seq(dev, cp, k->dp, k->p->n, k->p->nprime, k->p->r2,
+                       m1, k->nwords, label))
+        return 0;
+    if (!modexp_hw_seq(dev, cq, k->dq, k->q->n, k->q->nprime, k->q->r2,
+                       m2, k->nwords, label))
+        return 0;
+
+    rsa_crt_garner(k, m1, m2, m);
     return 1;
 }
 
-/* SW modular exponentiation (scalar exponent) */
-static void modexp_sw_scalar(const u32 *base,
-                             u32 exp,
-                             int exp_bits,
-                             const u32 *N,
-                             u32 *result,
-                             u32 nwords)
+/* the same with the halves on two cores at once: the p half starts on
+ * dev_p, c mod q is reduced and the q half fed to dev_q while it runs, and
+ * only then does the CPU wait for either. */
+static int rsa_decrypt_crt_hw2(mont_dev_t *dev_p, mont_dev_t *dev_q,
+                               const rsa_crt_key_t *k, const u32 *c, u32 *m,
+                               const char *label_p, const char *label_q)
 {
-    u32 one[MAX_WORDS];
-    u32 x[MAX_WORDS];
-    u32 a[MAX_WORDS];
-    int bit;
+    u32 cp[MAX_WORDS], cq[MAX_WORDS];
+    u32 m1[MAX_WORDS], m2[MAX_WORDS];
+    int ok;
 
-    bigint_set_u32(one, 1U, nwords);
-    bigint_set_u32(x, 1U, nwords);
-    bigint_copy(a, base, nwords);
+    bigint_mod(cp, c, 2U * k->nwords, k->p->n, k->nwords);
+    modexp_hw_seq_start(dev_p, cp, k->dp, k->p->n, k->p->nprime, k->p->r2, k->nwords);
 
-    for (bit = 0; bit < exp_bits; ++bit) {
-        if ((exp >> bit) & 1U)
-            modmul_sw(x, a, N, x, nwords);
-        modmul_sw(a, a, N, a, nwords);
-    }
+    bigint_mod(cq, c, 2U * k->nwords, k->q->n, k->nwords);
+    modexp_hw_seq_start(dev_q, cq, k->dq, k->q->n, k->q->nprime, k->q->r2, k->nwords);
 
-    bigint_copy(result, x, nwords);
+    /* collect both, so neither core is left with a job in flight */
+    ok  = modexp_hw_seq_finish(dev_p, m1, k->nwords, label_p);
+    ok &= modexp_hw_seq_finish(dev_q, m2, k->nwords, label_q);
+    if (!ok)
+        return 0;
+
+    rsa_crt_garner(k, m1, m2, m);
+    return 1;
+}
+
+/* the same with modexp_sw_window for both halves */
+static void rsa_decrypt_crt_sw(const rsa_crt_key_t *k, const u32 *c, u32 *m)
+{
+    u32 cp[MAX_WORDS], cq[MAX_WORDS];
+    u32 m1[MAX_WORDS], m2[MAX_WORDS];
+
+    bigint_mod(cp, c, 2U * k->nwords, k->p->n, k->nwords);
+    bigint_mod(cq, c, 2U * k->nwords, k->q->n, k->nwords);
+
+    modexp_sw_window(cp, k->dp, k->p->n, k->p->nprime, k->p->r2, m1, k->nwords);
+    modexp_sw_window(cq, k->dq, k->q->n, k->q->nprime, k->q->r2, m2, k->nwords);
+
+    rsa_crt_garner(k, m1, m2, m);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -337,24 +495,37 @@ static void modexp_sw_scalar(const u32 *base,
 
 static void benchmark_rsa_size(const char *label,
                                u32 key_bits,
-                               u32 nwords,
-                               u32 base_addr,
-                               const u32 *N,
-                               const u32 *R2,
-                               u32 nprime,
-                               u32 e, int e_bits,
-                               u32 d, int d_bits)
+                               mont_dev_t *dev,
+                               const mont_ctx_t *ctx,
+                               const mont_exp_t *e,
+                               const mont_exp_t *d)
 {
-    u32 msg[MAX_WORDS];
-    u32 c_hw[MAX_WORDS], m_hw[MAX_WORDS];
-    u32 c_sw[MAX_WORDS], m_sw[MAX_WORDS];
+    /* static: 4096-bit buffers would crowd a bare-metal stack */
+    static u32 msg[MAX_WORDS];
+    static u32 c_hw[MAX_WORDS], m_hw[MAX_WORDS];
+    static u32 c_sw[MAX_WORDS], m_sw[MAX_WORDS];
+    static u32 c_pp[MAX_WORDS], m_pp[MAX_WORDS];    /* one bus round trip per product */
+    static u32 c_fw[MAX_WORDS], m_fw[MAX_WORDS];    /* forwarded operands */
+    static u32 c_hwin[MAX_WORDS], m_hwin[MAX_WORDS];    /* sliding window, HW products */
+    static u32 c_swin[MAX_WORDS], m_swin[MAX_WORDS];    /* sliding window, SW products */
+    u32 nwords = ctx->nwords;
+    const u32 *N  = ctx->n;
+    const u32 *R2 = ctx->r2;
+    u32 nprime    = ctx->nprime;
 
     u64 enc_cycles_hw = 0, dec_cycles_hw = 0;
+    u64 enc_cycles_pp = 0, dec_cycles_pp = 0;
+    u64 enc_cycles_fw = 0, dec_cycles_fw = 0;
     u64 enc_cycles_sw = 0, dec_cycles_sw = 0;
+    u64 enc_cycles_hwin = 0, dec_cycles_hwin = 0;
+    u64 enc_cycles_swin = 0, dec_cycles_swin = 0;
+    u64 enc_clk_hw = 0, dec_clk_hw = 0;     /* accelerator clocks (sim backends) */
+    u32 mul_clk_hw = 0;                     /* core clocks of one product */
 
     xil_printf("\r\n==============================\r\n");
     xil_printf(" %s (key size: %u bits)\r\n", label, (unsigned)key_bits);
     xil_printf("==============================\r\n");
+    xil_printf(" e: %u bits, d: %u bits\r\n", (unsigned)e->bits, (unsigned)d->bits);
 
     bigint_copy(msg, RSA_MSG, nwords);
 
@@ -362,34 +533,108 @@ static void benchmark_rsa_size(const char *label,
                (unsigned)msg[0], (unsigned)msg[1],
                (unsigned)msg[2], (unsigned)msg[3]);
 
-    /* HW encrypt runs */
+    /* HW encrypt runs (on-chip sequencer) */
+    enc_clk_hw = mont_hal_cycles(dev);
     for (u32 run = 0; run < NUM_RUNS; ++run) {
         u64 start = Timer_GetCount();
-        if (!modexp_hw_scalar(base_addr, msg, e, e_bits, N, nprime, R2,
-                              c_hw, nwords, label)) {
+        if (!modexp_hw_seq(dev, msg, e, N, nprime, R2,
+                           c_hw, nwords, label)) {
             xil_printf("[ERROR] Aborting %s HW encrypt benchmark due to HW error.\r\n", label);
             return;
         }
         u64 end = Timer_GetCount();
         enc_cycles_hw += Timer_Delta(start, end);
     }
+    enc_clk_hw = mont_hal_cycles(dev) - enc_clk_hw;
 
-    /* HW decrypt runs */
+    /* HW decrypt runs (on-chip sequencer) */
+    dec_clk_hw = mont_hal_cycles(dev);
     for (u32 run = 0; run < NUM_RUNS; ++run) {
         u64 start = Timer_GetCount();
-        if (!modexp_hw_scalar(base_addr, c_hw, d, d_bits, N, nprime, R2,
-                              m_hw, nwords, label)) {
+        if (!modexp_hw_seq(dev, c_hw, d, N, nprime, R2,
+                           m_hw, nwords, label)) {
             xil_printf("[ERROR] Aborting %s HW decrypt benchmark due to HW error.\r\n", label);
             return;
         }
         u64 end = Timer_GetCount();
         dec_cycles_hw += Timer_Delta(start, end);
     }
+    dec_clk_hw = mont_hal_cycles(dev) - dec_clk_hw;
+
+    /* HW encrypt/decrypt, one montgomery_mul_hw call per product */
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        if (!modexp_hw_scalar(dev, msg, e, N, nprime, R2,
+                              c_pp, nwords, label)) {
+            xil_printf("[ERROR] Aborting %s HW encrypt benchmark due to HW error.\r\n", label);
+            return;
+        }
+        u64 end = Timer_GetCount();
+        enc_cycles_pp += Timer_Delta(start, end);
+    }
+    mul_clk_hw = mont_hal_read_reg(dev, REG_CYCLES);
+
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        if (!modexp_hw_scalar(dev, c_pp, d, N, nprime, R2,
+                              m_pp, nwords, label)) {
+            xil_printf("[ERROR] Aborting %s HW decrypt benchmark due to HW error.\r\n", label);
+            return;
+        }
+        u64 end = Timer_GetCount();
+        dec_cycles_pp += Timer_Delta(start, end);
+    }
+
+    /* HW encrypt/decrypt, CPU-scheduled products on forwarded operands */
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        if (!modexp_hw_fwd(dev, msg, e, N, nprime, R2,
+                           c_fw, nwords, label)) {
+            xil_printf("[ERROR] Aborting %s HW encrypt benchmark due to HW error.\r\n", label);
+            return;
+        }
+        u64 end = Timer_GetCount();
+        enc_cycles_fw += Timer_Delta(start, end);
+    }
+
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        if (!modexp_hw_fwd(dev, c_fw, d, N, nprime, R2,
+                           m_fw, nwords, label)) {
+            xil_printf("[ERROR] Aborting %s HW decrypt benchmark due to HW error.\r\n", label);
+            return;
+        }
+        u64 end = Timer_GetCount();
+        dec_cycles_fw += Timer_Delta(start, end);
+    }
+
+    /* HW encrypt/decrypt, sliding window over per-product calls */
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        if (!modexp_hw_window(dev, msg, e, N, nprime, R2,
+                              c_hwin, nwords, label)) {
+            xil_printf("[ERROR] Aborting %s HW encrypt benchmark due to HW error.\r\n", label);
+            return;
+        }
+        u64 end = Timer_GetCount();
+        enc_cycles_hwin += Timer_Delta(start, end);
+    }
+
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        if (!modexp_hw_window(dev, c_hwin, d, N, nprime, R2,
+                              m_hwin, nwords, label)) {
+            xil_printf("[ERROR] Aborting %s HW decrypt benchmark due to HW error.\r\n", label);
+            return;
+        }
+        u64 end = Timer_GetCount();
+        dec_cycles_hwin += Timer_Delta(start, end);
+    }
 
     /* SW encrypt runs */
     for (u32 run = 0; run < NUM_RUNS; ++run) {
         u64 start = Timer_GetCount();
-        modexp_sw_scalar(msg, e, e_bits, N, c_sw, nwords);
+        modexp_sw_scalar(msg, e, N, nprime, R2, c_sw, nwords);
         u64 end = Timer_GetCount();
         enc_cycles_sw += Timer_Delta(start, end);
     }
@@ -397,29 +642,61 @@ static void benchmark_rsa_size(const char *label,
     /* SW decrypt runs */
     for (u32 run = 0; run < NUM_RUNS; ++run) {
         u64 start = Timer_GetCount();
-        modexp_sw_scalar(c_sw, d, d_bits, N, m_sw, nwords);
+        modexp_sw_scalar(c_sw, d, N, nprime, R2, m_sw, nwords);
         u64 end = Timer_GetCount();
         dec_cycles_sw += Timer_Delta(start, end);
     }
 
+    /* SW encrypt/decrypt, sliding window */
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        modexp_sw_window(msg, e, N, nprime, R2, c_swin, nwords);
+        u64 end = Timer_GetCount();
+        enc_cycles_swin += Timer_Delta(start, end);
+    }
+
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        modexp_sw_window(c_swin, d, N, nprime, R2, m_swin, nwords);
+        u64 end = Timer_GetCount();
+        dec_cycles_swin += Timer_Delta(start, end);
+    }
+
     u64 enc_hw_avg = enc_cycles_hw / NUM_RUNS;
     u64 dec_hw_avg = dec_cycles_hw / NUM_RUNS;
     u64 enc_sw_avg = enc_cycles_sw / NUM_RUNS;
     u64 dec_sw_avg = dec_cycles_sw / NUM_RUNS;
+    u64 enc_pp_avg = enc_cycles_pp / NUM_RUNS;
+    u64 dec_pp_avg = dec_cycles_pp / NUM_RUNS;
+    u64 enc_fw_avg = enc_cycles_fw / NUM_RUNS;
+    u64 dec_fw_avg = dec_cycles_fw / NUM_RUNS;
+    u64 enc_hwin_avg = enc_cycles_hwin / NUM_RUNS;
+    u64 dec_hwin_avg = dec_cycles_hwin / NUM_RUNS;
+    u64 enc_swin_avg = enc_cycles_swin / NUM_RUNS;
+    u64 dec_swin_avg = dec_cycles_swin / NUM_RUNS;
 
     /* time elapsed (ns) */
-    u64 enc_hw_ns = (enc_hw_avg * 1000000000ULL) / (u64)GTIMER_FREQ_HZ;
-    u64 dec_hw_ns = (dec_hw_avg * 1000000000ULL) / (u64)GTIMER_FREQ_HZ;
-    u64 enc_sw_ns = (enc_sw_avg * 1000000000ULL) / (u64)GTIMER_FREQ_HZ;
-    u64 dec_sw_ns = (dec_sw_avg * 1000000000ULL) / (u64)GTIMER_FREQ_HZ;
+    u64 timer_hz   = Timer_GetFreqHz();
+    u64 enc_hw_ns = (enc_hw_avg * 1000000000ULL) / timer_hz;
+    u64 dec_hw_ns = (dec_hw_avg * 1000000000ULL) / timer_hz;
+    u64 enc_sw_ns = (enc_sw_avg * 1000000000ULL) / timer_hz;
+    u64 dec_sw_ns = (dec_sw_avg * 1000000000ULL) / timer_hz;
+    u64 enc_pp_ns = (enc_pp_avg * 1000000000ULL) / timer_hz;
+    u64 dec_pp_ns = (dec_pp_avg * 1000000000ULL) / timer_hz;
+    u64 enc_fw_ns = (enc_fw_avg * 1000000000ULL) / timer_hz;
+    u64 dec_fw_ns = (dec_fw_avg * 1000000000ULL) / timer_hz;
+    u64 enc_hwin_ns = (enc_hwin_avg * 1000000000ULL) / timer_hz;
+    u64 dec_hwin_ns = (dec_hwin_avg * 1000000000ULL) / timer_hz;
+    u64 enc_swin_ns = (enc_swin_avg * 1000000000ULL) / timer_hz;
+    u64 dec_swin_ns = (dec_swin_avg * 1000000000ULL) / timer_hz;
 
     /* throughput in bits/s and Mbit/s */
     u64 bits_per_op = (u64)key_bits;
 
-    u64 enc_hw_bits_s = (enc_hw_avg > 0) ? (bits_per_op * (u64)GTIMER_FREQ_HZ) / enc_hw_avg : 0;
-    u64 dec_hw_bits_s = (dec_hw_avg > 0) ? (bits_per_op * (u64)GTIMER_FREQ_HZ) / dec_hw_avg : 0;
-    u64 enc_sw_bits_s = (enc_sw_avg > 0) ? (bits_per_op * (u64)GTIMER_FREQ_HZ) / enc_sw_avg : 0;
-    u64 dec_sw_bits_s = (dec_sw_avg > 0) ? (bits_per_op * (u64)GTIMER_FREQ_HZ) / dec_sw_avg : 0;
+    u64 enc_hw_bits_s = (enc_hw_avg > 0) ? (bits_per_op * timer_hz) / enc_hw_avg : 0;
+    u64 dec_hw_bits_s = (dec_hw_avg > 0) ? (bits_per_op * timer_hz) / dec_hw_avg : 0;
+    u64 enc_sw_bits_s = (enc_sw_avg > 0) ? (bits_per_op * timer_hz) / enc_sw_avg : 0;
+    u64 dec_sw_bits_s = (dec_sw_avg > 0) ? (bits_per_op * timer_hz) / dec_sw_avg : 0;
 
     u32 enc_hw_mbps = (u32)(enc_hw_bits_s / 1000000ULL);
     u32 dec_hw_mbps = (u32)(dec_hw_bits_s / 1000000ULL);
@@ -460,12 +737,42 @@ static void benchmark_rsa_size(const char *label,
                (unsigned long)dec_hw_avg, (unsigned long)dec_hw_ns,
                (unsigned)dec_hw_mbps);
 
+    if (enc_clk_hw != 0 || dec_clk_hw != 0) {
+        xil_printf(" HW enc: avg %lu accelerator clocks (%s)\r\n",
+                   (unsigned long)(enc_clk_hw / NUM_RUNS), dev->backend);
+        xil_printf(" HW dec: avg %lu accelerator clocks (%s)\r\n",
+                   (unsigned long)(dec_clk_hw / NUM_RUNS), dev->backend);
+    }
+
+    xil_printf(" HW enc, per-product driver: avg %lu cycles, %lu ns\r\n",
+               (unsigned long)enc_pp_avg, (unsigned long)enc_pp_ns);
+    xil_printf(" HW dec, per-product driver: avg %lu cycles, %lu ns\r\n",
+               (unsigned long)dec_pp_avg, (unsigned long)dec_pp_ns);
+    xil_printf(" HW enc, forwarded operands: avg %lu cycles, %lu ns\r\n",
+               (unsigned long)enc_fw_avg, (unsigned long)enc_fw_ns);
+    xil_printf(" HW dec, forwarded operands: avg %lu cycles, %lu ns\r\n",
+               (unsigned long)dec_fw_avg, (unsigned long)dec_fw_ns);
+    xil_printf(" HW enc, sliding window (w=%u): avg %lu cycles, %lu ns\r\n",
+               (unsigned)modexp_window_bits(e->bits),
+               (unsigned long)enc_hwin_avg, (unsigned long)enc_hwin_ns);
+    xil_printf(" HW dec, sliding window (w=%u): avg %lu cycles, %lu ns\r\n",
+               (unsigned)modexp_window_bits(d->bits),
+               (unsigned long)dec_hwin_avg, (unsigned long)dec_hwin_ns);
+
+    if (mul_clk_hw != 0U)
+        xil_printf(" HW core: %u clocks per Montgomery product\r\n",
+                   (unsigned)mul_clk_hw);
+
     xil_printf(" SW enc: avg %lu cycles, %lu ns, %u Mbit/s\r\n",
                (unsigned long)enc_sw_avg, (unsigned long)enc_sw_ns,
                (unsigned)enc_sw_mbps);
     xil_printf(" SW dec: avg %lu cycles, %lu ns, %u Mbit/s\r\n",
                (unsigned long)dec_sw_avg, (unsigned long)dec_sw_ns,
                (unsigned)dec_sw_mbps);
+    xil_printf(" SW enc, sliding window: avg %lu cycles, %lu ns\r\n",
+               (unsigned long)enc_swin_avg, (unsigned long)enc_swin_ns);
+    xil_printf(" SW dec, sliding window: avg %lu cycles, %lu ns\r\n",
+               (unsigned long)dec_swin_avg, (unsigned long)dec_swin_ns);
 
     xil_printf(" Enc speedup (SW/HW): %u.%03ux\r\n",
                (unsigned)enc_spd_int, (unsigned)enc_spd_frac);
@@ -475,8 +782,537 @@ static void benchmark_rsa_size(const char *label,
     xil_printf("\r\n[Correctness]\r\n");
     xil_printf(" HW dec == msg: %s\r\n",
                bigint_equal(m_hw, msg, nwords) ? "OK" : "FAIL");
+    xil_printf(" HW dec (per product) == msg: %s\r\n",
+               bigint_equal(m_pp, msg, nwords) ? "OK" : "FAIL");
+    xil_printf(" HW dec (forwarded) == msg: %s\r\n",
+               bigint_equal(m_fw, msg, nwords) ? "OK" : "FAIL");
+    xil_printf(" HW dec (sliding window) == msg: %s\r\n",
+               bigint_equal(m_hwin, msg, nwords) ? "OK" : "FAIL");
     xil_printf(" SW dec == msg: %s\r\n",
                bigint_equal(m_sw, msg, nwords) ? "OK" : "FAIL");
+    xil_printf(" SW dec (sliding window) == msg: %s\r\n",
+               (bigint_equal(m_swin, msg, nwords) &&
+                bigint_equal(c_swin, c_sw, nwords)) ? "OK" : "FAIL");
+}
+
+/* -------------------------------------------------------------------------- */
+/* RSA-2048 decryption: CRT on the 1024-bit core vs. one 2048-bit modexp     */
+/* -------------------------------------------------------------------------- */
+
+static void benchmark_rsa_crt(const char *label,
+                              mont_dev_t *dev,          /* full-size key */
+                              mont_dev_t *dev_half,     /* CRT halves */
+                              const char *label_half,
+                              mont_dev_t *dev_q,        /* q half, or NULL */
+                              const char *label_q,
+                              const mont_ctx_t *ctx,    /* n = p * q */
+                              const mont_exp_t *e,
+                              const mont_exp_t *d,
+                              const rsa_crt_key_t *k)
+{
+    static u32 c[MAX_WORDS];
+    static u32 m_hw[MAX_WORDS], m_crt[MAX_WORDS], m_crt2[MAX_WORDS];
+    static u32 m_sw[MAX_WORDS], m_swcrt[MAX_WORDS];
+    u32 nwords = ctx->nwords;
+    const u32 *N  = ctx->n;
+    const u32 *R2 = ctx->r2;
+    u32 nprime    = ctx->nprime;
+    u64 t_hw = 0, t_crt = 0, t_crt2 = 0, t_sw = 0, t_swcrt = 0;
+
+    modexp_sw_window(RSA_MSG, e, N, nprime, R2, c, nwords);
+
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        if (!modexp_hw_seq(dev, c, d, N, nprime, R2, m_hw, nwords, label)) {
+            xil_printf("[ERROR] Aborting %s CRT benchmark due to HW error.\r\n", label);
+            return;
+        }
+        t_hw += Timer_Delta(start, Timer_GetCount());
+    }
+
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        if (!rsa_decrypt_crt_hw(dev_half, k, c, m_crt, label_half)) {
+            xil_printf("[ERROR] Aborting %s CRT benchmark due to HW error.\r\n", label);
+            return;
+        }
+        t_crt += Timer_Delta(start, Timer_GetCount());
+    }
+
+    for (u32 run = 0; dev_q != NULL && run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        if (!rsa_decrypt_crt_hw2(dev_half, dev_q, k, c, m_crt2,
+                                 label_half, label_q)) {
+            xil_printf("[ERROR] Aborting %s CRT benchmark due to HW error.\r\n", label);
+            return;
+        }
+        t_crt2 += Timer_Delta(start, Timer_GetCount());
+    }
+
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        modexp_sw_window(c, d, N, nprime, R2, m_sw, nwords);
+        t_sw += Timer_Delta(start, Timer_GetCount());
+    }
+
+    for (u32 run = 0; run < NUM_RUNS; ++run) {
+        u64 start = Timer_GetCount();
+        rsa_decrypt_crt_sw(k, c, m_swcrt);
+        t_swcrt += Timer_Delta(start, Timer_GetCount());
+    }
+
+    t_hw /= NUM_RUNS;
+    t_crt /= NUM_RUNS;
+    t_crt2 /= NUM_RUNS;
+    t_sw /= NUM_RUNS;
+    t_swcrt /= NUM_RUNS;
+
+    u64 timer_hz = Timer_GetFreqHz();
+    u64 hw_spd_x1000 = (t_crt > 0) ? (t_hw * 1000ULL) / t_crt : 0;
+    u64 sw_spd_x1000 = (t_swcrt > 0) ? (t_sw * 1000ULL) / t_swcrt : 0;
+
+    xil_printf("\r\n[CRT] %s decrypt, halves on %s (dp: %u bits, dq: %u bits)\r\n",
+               label, label_half, (unsigned)k->dp->bits, (unsigned)k->dq->bits);
+    xil_printf(" HW dec, no CRT: avg %lu cycles, %lu ns\r\n",
+               (unsigned long)t_hw, (unsigned long)((t_hw * 1000000000ULL) / timer_hz));
+    xil_printf(" HW dec, CRT:    avg %lu cycles, %lu ns\r\n",
+               (unsigned long)t_crt, (unsigned long)((t_crt * 1000000000ULL) / timer_hz));
+    if (dev_q != NULL)
+        xil_printf(" HW dec, CRT on two cores: avg %lu cycles, %lu ns\r\n",
+                   (unsigned long)t_crt2,
+                   (unsigned long)((t_crt2 * 1000000000ULL) / timer_hz));
+    else
+        xil_printf(" HW dec, CRT on two cores: not available (needs a KEY_LEN core and montgomery_axi_1024_0)\r\n");
+    xil_printf(" SW dec, no CRT: avg %lu cycles, %lu ns\r\n",
+               (unsigned long)t_sw, (unsigned long)((t_sw * 1000000000ULL) / timer_hz));
+    xil_printf(" SW dec, CRT:    avg %lu cycles, %lu ns\r\n",
+               (unsigned long)t_swcrt, (unsigned long)((t_swcrt * 1000000000ULL) / timer_hz));
+    xil_printf(" CRT speedup HW: %u.%03ux, SW: %u.%03ux\r\n",
+               (unsigned)(hw_spd_x1000 / 1000ULL), (unsigned)(hw_spd_x1000 % 1000ULL),
+               (unsigned)(sw_spd_x1000 / 1000ULL), (unsigned)(sw_spd_x1000 % 1000ULL));
+    xil_printf(" HW dec (CRT) == msg: %s\r\n",
+               (bigint_equal(m_crt, RSA_MSG, nwords) &&
+                bigint_equal(m_hw, RSA_MSG, nwords)) ? "OK" : "FAIL");
+    if (dev_q != NULL)
+        xil_printf(" HW dec (CRT, two cores) == msg: %s\r\n",
+                   bigint_equal(m_crt2, RSA_MSG, nwords) ? "OK" : "FAIL");
+    xil_printf(" SW dec (CRT) == msg: %s\r\n",
+               (bigint_equal(m_swcrt, RSA_MSG, nwords) &&
+                bigint_equal(m_sw, RSA_MSG, nwords)) ? "OK" : "FAIL");
+}
+
+/* -------------------------------------------------------------------------- */
+/* Stream of independent products: one bank vs. double-buffered banks        */
+/* -------------------------------------------------------------------------- */
+
+/* operands of product k (all < N) */
+static void stream_operands(u32 k, const u32 *N, u32 *A, u32 *B, u32 nwords)
+{
+    bigint_set_u32(A, (37U * k + 5U) % N[0], nwords);
+    bigint_set_u32(B, (101U * k + 7U) % N[0], nwords);
+}
+
+static void stream_load(mont_dev_t *dev, u32 k, const u32 *N, u32 nwords)
+{
+    u32 A[MAX_WORDS], B[MAX_WORDS];
+
+    stream_operands(k, N, A, B, nwords);
+    mont_hal_write_block(dev, REG_A(0), A, nwords);
+    mont_hal_write_block(dev, REG_B(0), B, nwords);
+}
+
+static void benchmark_mul_stream(const char *label,
+                                 mont_dev_t *dev,
+                                 const mont_ctx_t *ctx)
+{
+    static u32 res_single[STREAM_LEN][MAX_WORDS];
+    static u32 res_double[STREAM_LEN][MAX_WORDS];
+    u32 A[MAX_WORDS], B[MAX_WORDS], ref[MAX_WORDS];
+    u32 nwords = ctx->nwords;
+    const u32 *N  = ctx->n;
+    const u32 *R2 = ctx->r2;
+    u32 nprime    = ctx->nprime;
+    u64 t_single, t_double, start;
+    int ok = 1;
+
+    mont_hal_key_load(dev, nwords, N, R2, nprime, bigint_bits(N, nwords));
+
+    /* single bank: load, start, wait, read back, repeat */
+    start = Timer_GetCount();
+    for (u32 k = 0; k < STREAM_LEN; ++k) {
+        stream_operands(k, N, A, B, nwords);
+        if (!montgomery_mul_hw(dev, nwords, A, B, res_single[k], label))
+            return;
+    }
+    t_single = Timer_Delta(start, Timer_GetCount());
+
+    /* double-buffered: load bank k+1 and queue it while bank k computes */
+    start = Timer_GetCount();
+    stream_load(dev, 0U, N, nwords);
+    mont_hal_control(dev, CONTROL_START | CONTROL_BANK(0));
+    for (u32 k = 0; k < STREAM_LEN; ++k) {
+        u32 bank = k & 1U;
+
+        if (k + 1U < STREAM_LEN) {
+            mont_hal_control(dev, CONTROL_BANK(!bank));
+            stream_load(dev, k + 1U, N, nwords);
+            mont_hal_control(dev, CONTROL_START | CONTROL_BANK(!bank));
+        }
+
+        mont_hal_control(dev, CONTROL_BANK(bank));
+        if (!mont_hal_wait_done(dev, HW_DONE_TIMEOUT)) {
+            xil_printf("[ERROR] HW timeout in %s stream (bank %u)\r\n",
+                       label, (unsigned)bank);
+            return;
+        }
+        mont_hal_read_block(dev, REG_RES(0), res_double[k], nwords);
+    }
+    t_double = Timer_Delta(start, Timer_GetCount());
+    mont_hal_control(dev, CONTROL_BANK(0));
+
+    for (u32 k = 0; k < STREAM_LEN; ++k) {
+        stream_operands(k, N, A, B, nwords);
+        montgomery_mul_sw(nwords, A, B, N, nprime, ref);
+        if (!bigint_equal(res_single[k], ref, nwords) ||
+            !bigint_equal(res_double[k], ref, nwords))
+            ok = 0;
+    }
+
+    xil_printf("\r\n[Stream] %s, %u independent products\r\n",
+               label, (unsigned)STREAM_LEN);
+    xil_printf(" single bank:     avg %lu cycles/product\r\n",
+               (unsigned long)(t_single / STREAM_LEN));
+    xil_printf(" double-buffered: avg %lu cycles/product\r\n",
+               (unsigned long)(t_double / STREAM_LEN));
+    xil_printf(" results == SW: %s\r\n", ok ? "OK" : "FAIL");
+}
+
+/* -------------------------------------------------------------------------- */
+/* Products with operands in DDR: MMIO copies vs. descriptor DMA              */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    mont_dma_desc_t *desc;
+    u32              desc_phys;
+    u32             *a;
+    u32             *b;
+    u32             *res;
+} dma_job_t;
+
+/* descriptor plus A / B / result buffers; N stays in the key slot */
+static int dma_job_alloc(mont_dev_t *dev, dma_job_t *j, u32 nwords)
+{
+    u32 bytes = 4U * nwords;
+    u32 pa = 0U, pb = 0U, pr = 0U;
+
+    j->desc = (mont_dma_desc_t *)mont_hal_dma_alloc(dev, sizeof(mont_dma_desc_t),
+                                                    &j->desc_phys);
+    j->a    = (u32 *)mont_hal_dma_alloc(dev, bytes, &pa);
+    j->b    = (u32 *)mont_hal_dma_alloc(dev, bytes, &pb);
+    j->res  = (u32 *)mont_hal_dma_alloc(dev, bytes, &pr);
+    if (j->desc == NULL || j->a == NULL || j->b == NULL || j->res == NULL)
+        return 0;
+
+    j->desc->ctrl     = 0U;
+    j->desc->a_addr   = pa;
+    j->desc->b_addr   = pb;
+    j->desc->n_addr   = 0U;
+    j->desc->res_addr = pr;
+    j->desc->nprime   = 0U;
+    j->desc->exp_bits = 0U;
+    j->desc->done     = 0U;
+    return 1;
+}
+
+static int montgomery_mul_dma(mont_dev_t *dev,
+                              const dma_job_t *j,
+                              u32 nwords,
+                              const char *label)
+{
+    mont_hal_write_reg(dev, REG_DMA_DESC, j->desc_phys);
+    mont_hal_control(dev, CONTROL_START | CONTROL_DMA);
+
+    if (!mont_hal_wait_done(dev, HW_DONE_TIMEOUT)) {
+        xil_printf("[ERROR] HW timeout in montgomery_mul_dma for %s (%s, base 0x%08lx)\r\n",
+                   label, dev->backend, (unsigned long)dev->base);
+        return 0;
+    }
+    if (mont_hal_read_reg(dev, REG_STATUS) & STATUS_DMA_ERR) {
+        xil_printf("[ERROR] DMA bus error for %s (descriptor 0x%08lx)\r\n",
+                   label, (unsigned long)j->desc_phys);
+        return 0;
+    }
+
+    mont_hal_dma_sync(dev, j->res, 4U * nwords, 0);
+    return 1;
+}
+
+/* count entries through the ring, refilled as entries complete; entry k is
+ * a copy of jobs[k % njobs]'s descriptor on the current key slot */
+static int montgomery_mul_ring(mont_dev_t *dev,
+                               mont_ring_t *ring,
+                               const dma_job_t *jobs,
+                               u32 njobs,
+                               u32 count,
+                               u32 nwords,
+                               const char *label)
+{
+    u32 posted = 0U;
+
+    for (u32 k = 0; k < count; ++k) {
+        mont_dma_desc_t *d;
+        u32 done;
+
+        while (posted < count && (d = mont_hal_ring_next(ring)) != NULL) {
+            *d       = *jobs[posted % njobs].desc;
+            d->ctrl |= CONTROL_SLOT(dev->slot);
+            d->done  = 0U;
+            ++posted;
+        }
+        mont_hal_ring_doorbell(dev, ring);
+
+        done = mont_hal_ring_reap(dev, ring, HW_DONE_TIMEOUT);
+        if (done != RING_DONE) {
+            xil_printf("[ERROR] Ring entry %u for %s: %s\r\n", (unsigned)k, label,
+                       (done == 0U) ? "HW timeout" : "DMA bus error");
+            return 0;
+        }
+        mont_hal_dma_sync(dev, jobs[k % njobs].res, 4U * nwords, 0);
+    }
+    return 1;
+}
+
+static void benchmark_mul_dma(const char *label,
+                              mont_dev_t *dev,
+                              const mont_ctx_t *ctx,
+                              const mont_exp_t *d)
+{
+    static u32 res_mmio[STREAM_LEN][MAX_WORDS];
+    u32 nwords = ctx->nwords;
+    const u32 *N  = ctx->n;
+    const u32 *R2 = ctx->r2;
+    u32 nprime    = ctx->nprime;
+    dma_job_t jobs[STREAM_LEN];
+    dma_job_t jn, jm;
+    mont_ring_t ring;
+    u32 *n_buf;
+    u32 n_phys = 0U;
+    u32 ref[MAX_WORDS];
+    u64 t_mmio, t_dma, t_ring = 0ULL, t_run = 0ULL, clk_run = 0ULL, start;
+    u32 lanes = HWCFG_LANES(mont_hal_read_reg(dev, REG_HWCFG));
+    int ok = 1, ok_n, ok_ring, ok_run, ok_exp;
+
+    for (u32 k = 0; k < STREAM_LEN; ++k) {
+        if (!dma_job_alloc(dev, &jobs[k], nwords)) {
+            xil_printf("\r\n[DMA] %s: not available (no DMA_EN or no DMA memory)\r\n",
+                       label);
+            return;
+        }
+        stream_operands(k, N, jobs[k].a, jobs[k].b, nwords);
+        mont_hal_dma_sync(dev, jobs[k].desc, sizeof(mont_dma_desc_t), 1);
+        mont_hal_dma_sync(dev, jobs[k].a, 4U * nwords, 1);
+        mont_hal_dma_sync(dev, jobs[k].b, 4U * nwords, 1);
+    }
+
+    mont_hal_key_load(dev, nwords, N, R2, nprime, bigint_bits(N, nwords));
+
+    /* operands already in memory: CPU copies them through the GP port */
+    start = Timer_GetCount();
+    for (u32 k = 0; k < STREAM_LEN; ++k) {
+        if (!montgomery_mul_hw(dev, nwords, jobs[k].a, jobs[k].b, res_mmio[k], label))
+            return;
+    }
+    t_mmio = Timer_Delta(start, Timer_GetCount());
+
+    /* ... or the core fetches them itself: two register writes per product */
+    start = Timer_GetCount();
+    for (u32 k = 0; k < STREAM_LEN; ++k) {
+        if (!montgomery_mul_dma(dev, &jobs[k], nwords, label))
+            return;
+    }
+    t_dma = Timer_Delta(start, Timer_GetCount());
+
+    for (u32 k = 0; k < STREAM_LEN; ++k) {
+        montgomery_mul_sw(nwords, jobs[k].a, jobs[k].b, N, nprime, ref);
+        if (!bigint_equal(res_mmio[k], ref, nwords) ||
+            !bigint_equal(jobs[k].res, ref, nwords))
+            ok = 0;
+    }
+
+    /* ... or posts them all to the descriptor ring and only reaps results */
+    ok_ring = mont_hal_ring_init(dev, &ring, RING_LEN);
+    if (ok_ring) {
+        for (u32 k = 0; k < STREAM_LEN; ++k) {
+            bigint_set_u32(jobs[k].res, 0U, nwords);
+            mont_hal_dma_sync(dev, jobs[k].res, 4U * nwords, 1);
+        }
+        start   = Timer_GetCount();
+        ok_ring = montgomery_mul_ring(dev, &ring, jobs, STREAM_LEN, STREAM_LEN,
+                                      nwords, label);
+        t_ring  = Timer_Delta(start, Timer_GetCount());
+        for (u32 k = 0; ok_ring && k < STREAM_LEN; ++k) {
+            montgomery_mul_sw(nwords, jobs[k].a, jobs[k].b, N, nprime, ref);
+            if (!bigint_equal(jobs[k].res, ref, nwords))
+                ok_ring = 0;
+        }
+    }
+
+    /* a longer run keeps every lane busy: products per second */
+    ok_run = ok_ring;
+    if (ok_run) {
+        clk_run = mont_hal_cycles(dev);
+        start   = Timer_GetCount();
+        ok_run  = montgomery_mul_ring(dev, &ring, jobs, STREAM_LEN, RING_RUN_LEN,
+                                      nwords, label);
+        t_run   = Timer_Delta(start, Timer_GetCount());
+        clk_run = mont_hal_cycles(dev) - clk_run;
+        for (u32 k = 0; ok_run && k < STREAM_LEN; ++k) {
+            montgomery_mul_sw(nwords, jobs[k].a, jobs[k].b, N, nprime, ref);
+            if (!bigint_equal(jobs[k].res, ref, nwords))
+                ok_run = 0;
+        }
+    }
+
+    /* a whole exponentiation as one ring entry: B carries the exponent */
+    ok_exp = ok_ring && dma_job_alloc(dev, &jm, nwords);
+    if (ok_exp) {
+        bigint_copy(jm.a, RSA_MSG, nwords);
+        bigint_copy(jm.b, d->w, nwords);
+        jm.desc->ctrl     = CONTROL_MODEXP;
+        jm.desc->exp_bits = d->bits;
+        mont_hal_dma_sync(dev, jm.a, 4U * nwords, 1);
+        mont_hal_dma_sync(dev, jm.b, 4U * nwords, 1);
+
+        modexp_sw_scalar(RSA_MSG, d, N, nprime, R2, ref, nwords);
+        ok_exp = montgomery_mul_ring(dev, &ring, &jm, 1U, 1U, nwords, label) &&
+                 bigint_equal(jm.res, ref, nwords);
+    }
+
+    /* one job that also brings N and n' (into a scratch key slot) */
+    ok_n  = dma_job_alloc(dev, &jn, nwords);
+    n_buf = (u32 *)mont_hal_dma_alloc(dev, 4U * nwords, &n_phys);
+    if (ok_n && n_buf != NULL) {
+        stream_operands(STREAM_LEN, N, jn.a, jn.b, nwords);
+        bigint_copy(n_buf, N, nwords);
+        jn.desc->n_addr = n_phys;
+        jn.desc->nprime = nprime;
+        mont_hal_dma_sync(dev, jn.desc, sizeof(mont_dma_desc_t), 1);
+        mont_hal_dma_sync(dev, jn.a, 4U * nwords, 1);
+        mont_hal_dma_sync(dev, jn.b, 4U * nwords, 1);
+        mont_hal_dma_sync(dev, n_buf, 4U * nwords, 1);
+
+        mont_hal_key_scratch(dev, nwords);
+        montgomery_mul_sw(nwords, jn.a, jn.b, N, nprime, ref);
+        ok_n = montgomery_mul_dma(dev, &jn, nwords, label) &&
+               bigint_equal(jn.res, ref, nwords);
+    } else {
+        ok_n = 0;
+    }
+
+    xil_printf("\r\n[DMA] %s, %u products with operands in DDR\r\n",
+               label, (unsigned)STREAM_LEN);
+    xil_printf(" MMIO copies:     avg %lu cycles/product\r\n",
+               (unsigned long)(t_mmio / STREAM_LEN));
+    xil_printf(" descriptor DMA:  avg %lu cycles/product\r\n",
+               (unsigned long)(t_dma / STREAM_LEN));
+    xil_printf(" descriptor ring: avg %lu cycles/product (%u entries)\r\n",
+               (unsigned long)(t_ring / STREAM_LEN), (unsigned)RING_LEN);
+    xil_printf(" ring throughput: %u products on %u lane(s), %lu products/s\r\n",
+               (unsigned)RING_RUN_LEN, (unsigned)lanes,
+               (unsigned long)((t_run != 0ULL) ?
+                   (u64)RING_RUN_LEN * Timer_GetFreqHz() / t_run : 0ULL));
+    if (clk_run != 0ULL)
+        xil_printf(" ring throughput: %lu accelerator clocks/product\r\n",
+                   (unsigned long)(clk_run / RING_RUN_LEN));
+    xil_printf(" results == SW: %s\r\n", ok ? "OK" : "FAIL");
+    xil_printf(" ring results == SW: %s\r\n", (ok_ring && ok_run) ? "OK" : "FAIL");
+    xil_printf(" ring modexp == SW: %s\r\n", ok_exp ? "OK" : "FAIL");
+    xil_printf(" N via DMA == SW: %s\r\n", ok_n ? "OK" : "FAIL");
+}
+
+/* -------------------------------------------------------------------------- */
+/* Montgomery context known-answer test                                      */
+/*   The toy key is a single word; this fixed 2048-bit modulus checks        */
+/*   mont_ctx_get() and modexp_window() on a full-width N. Reference values   */
+/*   computed offline with Python big integers.                               */
+/* -------------------------------------------------------------------------- */
+
+/* N: odd, top bit set, LS word first */
+static const u32 KAT_N[NWORDS_2048] = {
+    0xd33af401U, 0x075c1409U, 0x7b376fa2U, 0x1a24893cU, 0x96357271U,
+    0xcee5fa08U, 0x0f6ec1a1U, 0x5da76cdaU, 0x437d2edcU, 0x0dfff446U,
+    0x1c5818cfU, 0x179d9feaU, 0x5e5fcbe7U, 0xac1faf04U, 0x80456675U,
+    0x7a816bb6U, 0x7f933f6dU, 0xfaf80318U, 0xe8a7da1aU, 0xdbf3cef9U,
+    0x5711c88cU, 0x206cac20U, 0xd33dd257U, 0x0fcd51ffU, 0x7b0e601fU,
+    0x72e2f481U, 0x0e31b75cU, 0xa141ec5fU, 0x0fe97c89U, 0x3152644dU,
+    0x4a275258U, 0x41e43380U, 0x2a1011cfU, 0x6e876321U, 0xc671b140U,
+    0x1f9b47a4U, 0x65dcb5abU, 0xeb80a8a5U, 0x4752749cU, 0x272fc15aU,
+    0xe2857f6fU, 0x8e5bfbd8U, 0xf7091152U, 0x9f1f219cU, 0xdca57324U,
+    0x2f04cd18U, 0xff0f32d7U, 0xa23246b6U, 0x1b2b589cU, 0xb2d1153bU,
+    0x0ca70c8eU, 0xdef7cd8cU, 0xb12e975eU, 0x538b8159U, 0x75ece3a7U,
+    0xa33d978cU, 0xb3f275a6U, 0x3e9f0f76U, 0x94555544U, 0xb67656c3U,
+    0x6af8e384U, 0x0be79490U, 0x79bb27b2U, 0xab73d67eU
+};
+
+#define KAT_NPRIME      0x9aaaf3ffU     /* -N^{-1} mod 2^32 */
+
+/* R^2 mod N, R = 2^2048 */
+static const u32 KAT_R2[NWORDS_2048] = {
+    0x207727adU, 0xc98572e5U, 0x93c8fdcfU, 0x5fd42bc9U, 0x3c35394dU,
+    0x923034a3U, 0x0b2ed6d4U, 0x456cb8a4U, 0xb9cc04c4U, 0xfe473011U,
+    0x3934f134U, 0x17141b35U, 0xe1bc74b4U, 0xe2d27321U, 0xb1e3be89U,
+    0xfc70ad01U, 0xc09670baU, 0x2c6e6518U, 0x7f1b8dd2U, 0x17aba3beU,
+    0x5996dd56U, 0x934a56daU, 0x98083519U, 0x2c600c69U, 0x0c04f888U,
+    0xd8b793acU, 0xf74ce06cU, 0x14a89d75U, 0x5e1b384aU, 0xed3434d1U,
+    0xa4eaa963U, 0x4f8ed4ceU, 0x8da12283U, 0x20af36e1U, 0xaf9253a5U,
+    0x1cf61ef9U, 0x4e6315d2U, 0x7f118e59U, 0xd2759672U, 0x9d8f3aa9U,
+    0x640a67f3U, 0xdfa55810U, 0x2b988cefU, 0xc0480007U, 0xc062605dU,
+    0xaf096fb1U, 0xe2c85d91U, 0xf9d18531U, 0xc4e4103aU, 0xb6873158U,
+    0xce971324U, 0xac652c45U, 0x160532d0U, 0x1bd113b6U, 0xfdce6260U,
+    0x0de445dfU, 0x0367b94bU, 0x07966a1aU, 0xbd0775f9U, 0x71d01dbdU,
+    0xd9b85d25U, 0x4ec0498bU, 0x5fa255ffU, 0x1e76c2a6U
+};
+
+/* 3^N mod N */
+static const u32 KAT_POW[NWORDS_2048] = {
+    0x33bfd507U, 0x9e5fb626U, 0xfba288e2U, 0x5f1a7e8cU, 0x3f464637U,
+    0xee4066e1U, 0xde83850aU, 0x912efb39U, 0x4a16aaa5U, 0x111fa6ffU,
+    0xd4dc6498U, 0x14d84bffU, 0x38f3f07fU, 0x465292a0U, 0xa4b6326fU,
+    0x3048b7aaU, 0x2ea9ed0aU, 0xddbd2399U, 0x4dd34f15U, 0x096c4588U,
+    0x75705520U, 0x0c50d28fU, 0xd6bf7986U, 0x1db31bddU, 0x39479469U,
+    0xcb6f0446U, 0x98636c22U, 0xe862ee9fU, 0xaffde29eU, 0xacf5d8dbU,
+    0x634ff519U, 0x0b7468e6U, 0xe1bb0bbaU, 0xa91ea65eU, 0xc887ac98U,
+    0xcbe5e176U, 0xc55415cbU, 0x6d6ac7c9U, 0xd17ce13cU, 0xd45ee89cU,
+    0xd4855e9aU, 0xb0ea9a69U, 0x864af945U, 0xb7edc153U, 0xa5c4eb39U,
+    0xb41086e6U, 0x1a2ce57aU, 0x9f13ba8dU, 0xbf8b9488U, 0xeb9ef8f3U,
+    0xb57656b5U, 0xcead9b3eU, 0x36e166a8U, 0x1d31d66fU, 0x534dd0e3U,
+    0x8c88f16eU, 0xd6d6b8daU, 0x55c45417U, 0x18f9bb49U, 0x21495afbU,
+    0x847ba335U, 0x5d7c7e1bU, 0xd60ac08dU, 0xa1b9bc11U
+};
+
+static void check_mont_ctx_kat(void)
+{
+    static mont_exp_t exp;
+    static u32 base[MAX_WORDS], result[MAX_WORDS];
+    const mont_ctx_t *ctx = mont_ctx_get(KAT_N, NWORDS_2048);
+    int ok_ctx, ok_exp = 0;
+
+    ok_ctx = ctx != NULL && ctx->nprime == KAT_NPRIME &&
+             bigint_equal(ctx->r2, KAT_R2, NWORDS_2048);
+    if (ctx != NULL) {
+        bigint_set_u32(exp.w, 0U, MAX_WORDS);
+        bigint_copy(exp.w, KAT_N, NWORDS_2048);
+        exp.bits = 2048U;
+        bigint_set_u32(base, 3U, NWORDS_2048);
+        modexp_sw_window(base, &exp, ctx->n, ctx->nprime, ctx->r2,
+                         result, NWORDS_2048);
+        ok_exp = bigint_equal(result, KAT_POW, NWORDS_2048);
+    }
+
+    xil_printf("\r\n[Correctness] Montgomery context, 2048-bit N\r\n");
+    xil_printf(" n' and R^2 mod N == reference: %s\r\n", ok_ctx ? "OK" : "FAIL");
+    xil_printf(" SW 3^N mod N (sliding window) == reference: %s\r\n",
+               ok_exp ? "OK" : "FAIL");
 }
 
 /* -------------------------------------------------------------------------- */
@@ -485,41 +1321,113 @@ static void benchmark_rsa_size(const char *label,
 
 int main(void)
 {
+    static mont_dev_t dev2048, dev1024_own;
+    mont_dev_t *dev1024 = &dev2048;
+    mont_dev_t *crt_q   = NULL;         /* second core for the CRT q half */
+    const mont_ctx_t *ctx2048, *ctx1024;
+    rsa_crt_key_t crt;
+    int have1024;
+    const char *label1024 = "RSA-1024 (HW: montgomery_axi_0, KEY_LEN 1024)";
+
     xil_printf("RSA HW/SW benchmarks with Montgomery accelerators\r\n");
 
     Timer_Init();
 
-    /* Precompute Montgomery parameters for each key size */
-    init_mont_params_for_size(NWORDS_1024, RSA_R2_1024, &NPRIME_1024);
-    init_mont_params_for_size(NWORDS_2048, RSA_R2_2048, &NPRIME_2048);
+    if (!mont_hal_open(&dev2048, MONT_CORE_2048)) {
+        xil_printf("[ERROR] Could not open Montgomery accelerators\r\n");
+        return 1;
+    }
+    /* a varlen core runs 1024-bit keys itself, else use the 1024 instance;
+     * with both, the instance takes the second CRT half */
+    have1024 = mont_hal_open(&dev1024_own, MONT_CORE_1024);
+    if (!mont_hal_width_ok(&dev2048, NWORDS_1024)) {
+        if (!have1024) {
+            xil_printf("[ERROR] Could not open Montgomery accelerators\r\n");
+            return 1;
+        }
+        dev1024   = &dev1024_own;
+        label1024 = "RSA-1024 (HW: montgomery_axi_1024)";
+    } else if (have1024 && mont_hal_width_ok(&dev1024_own, NWORDS_1024)) {
+        crt_q = &dev1024_own;
+    }
+    xil_printf("[INFO] Accelerator backend: %s\r\n", dev2048.backend);
+    xil_printf("[INFO] 1024-bit keys on: %s\r\n",
+               (dev1024 == &dev2048) ? "montgomery_axi_0 (KEY_LEN)"
+                                     : "montgomery_axi_1024_0");
+    xil_printf("[INFO] Core clock: %s\r\n",
+               (mont_hal_read_reg(&dev2048, REG_HWCFG) & HWCFG_CORE_CLK) ?
+               "core_clk (CYCLES counts s_axi clocks)" : "s_axi_aclk");
+
+    if (HW_SPIN_POLLS != ~0U) {
+        int irq = mont_hal_irq_enable(&dev2048, HW_SPIN_POLLS);
+        if (have1024)
+            irq &= mont_hal_irq_enable(&dev1024_own, HW_SPIN_POLLS);
+        xil_printf("[INFO] Done interrupt: %s\r\n",
+                   irq ? "spin, then block" : "not available, polling");
+    }
+
+    /* Montgomery contexts, computed once per modulus at key load */
+    {
+        u64 t0 = Timer_GetCount();
+        ctx2048 = mont_ctx_get(RSA_N, NWORDS_2048);
+        u64 t1 = Timer_GetCount();
+        (void)mont_ctx_get(RSA_N, NWORDS_2048);
+        u64 t2 = Timer_GetCount();
+
+        xil_printf("[INFO] 2048-bit Montgomery context: %lu cycles to build, %lu cached\r\n",
+                   (unsigned long)Timer_Delta(t0, t1), (unsigned long)Timer_Delta(t1, t2));
+    }
+    ctx1024 = mont_ctx_get(RSA_N, NWORDS_1024);
+    crt.p   = mont_ctx_get(RSA_P, NWORDS_1024);
+    crt.q   = mont_ctx_get(RSA_Q, NWORDS_1024);
+    if (ctx2048 == NULL || ctx1024 == NULL || crt.p == NULL || crt.q == NULL) {
+        xil_printf("[ERROR] Invalid RSA modulus\r\n");
+        return 1;
+    }
+    check_mont_ctx_kat();
+
+    mont_exp_set_u32(&RSA_E_EXP, RSA_E);
+    rsa_exp_stretch(&RSA_D_1024, RSA_D, RSA_LAMBDA, 1024U, 0x1024D001U);
+    rsa_exp_stretch(&RSA_D_2048, RSA_D, RSA_LAMBDA, 2048U, 0x2048D001U);
+    rsa_exp_stretch(&RSA_DP_1024, RSA_DP, RSA_P[0] - 1U, 1024U, 0x1024D0A1U);
+    rsa_exp_stretch(&RSA_DQ_1024, RSA_DQ, RSA_Q[0] - 1U, 1024U, 0x1024D0B1U);
+    crt.nwords = NWORDS_1024;
+    crt.dp     = &RSA_DP_1024;
+    crt.dq     = &RSA_DQ_1024;
+    crt.qinv   = RSA_QINV;
 
     /* 2048-bit benchmark (HW: montgomery_axi_0) */
-    benchmark_rsa_size("RSA-2048 (HW: montgomery_axi_0)",
-                       2048U,
-                       NWORDS_2048,
-                       MONT2048_BASE,
-                       RSA_N,
-                       RSA_R2_2048,
-                       NPRIME_2048,
-                       RSA_E, RSA_E_BITS,
-                       RSA_D, RSA_D_BITS);
-
-    /* 1024-bit benchmark (HW: montgomery_axi_1024) */
-    benchmark_rsa_size("RSA-1024 (HW: montgomery_axi_1024)",
-                       1024U,
-                       NWORDS_1024,
-                       MONT1024_BASE,
-                       RSA_N,
-                       RSA_R2_1024,
-                       NPRIME_1024,
-                       RSA_E, RSA_E_BITS,
-                       RSA_D, RSA_D_BITS);
+    benchmark_rsa_size("RSA-2048 (HW: montgomery_axi_0)", 2048U,
+                       &dev2048, ctx2048, &RSA_E_EXP, &RSA_D_2048);
+
+    /* 1024-bit benchmark (HW: KEY_LEN 1024 on montgomery_axi_0, or
+     * montgomery_axi_1024) */
+    benchmark_rsa_size(label1024, 1024U,
+                       dev1024, ctx1024, &RSA_E_EXP, &RSA_D_1024);
+
+    benchmark_rsa_crt("RSA-2048 (HW: montgomery_axi_0)", &dev2048,
+                      dev1024, label1024,
+                      crt_q, "RSA-1024 (HW: montgomery_axi_1024)",
+                      ctx2048, &RSA_E_EXP, &RSA_D_2048, &crt);
+
+    benchmark_mul_stream("RSA-2048 (HW: montgomery_axi_0)", &dev2048, ctx2048);
+    benchmark_mul_stream(label1024, dev1024, ctx1024);
+
+    benchmark_mul_dma("RSA-2048 (HW: montgomery_axi_0)", &dev2048, ctx2048,
+                      &RSA_D_2048);
+    benchmark_mul_dma(label1024, dev1024, ctx1024, &RSA_D_1024);
 
     xil_printf("\r\nAll benchmarks finished.\r\n");
 
+    if (have1024)
+        mont_hal_close(&dev1024_own);
+    mont_hal_close(&dev2048);
+
+#if !MONT_HAL_LINUX
     while (1) {
         /* idle */
     }
+#endif
 
     return 0;
 }
@@ -0,0 +1,397 @@
+/* -------------------------------------------------------------------------- */
+/* mont_hal.c                                                                 */
+/* Platform glue: default backend selection, timer, shared polling loop      */
+/* -------------------------------------------------------------------------- */
+#include "mont_hal.h"
+
+#if MONT_HAL_LINUX
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#else
+#include "xparameters.h"
+#include "xil_io.h"
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* Instance table                                                             */
+/* -------------------------------------------------------------------------- */
+
+#if MONT_HAL_LINUX
+/* Vivado's default GP0 assignments for the two IP blocks; override with
+ * $MONT_PHYS_2048 / $MONT_PHYS_1024 if the address editor says otherwise. */
+#define MONT2048_PHYS   0x43C00000U
+#define MONT1024_PHYS   0x43C10000U
+#else
+/* 2048-bit Montgomery accelerator (original core) */
+#define MONT2048_BASE   XPAR_MONTGOMERY_AXI_0_BASEADDR
+
+/* 1024-bit Montgomery accelerator (new 1024-bit IP block) */
+/* If your IP name is different, adjust this macro, e.g.:
+ *   #define MONT1024_BASE  XPAR_MONTGOMERY_AXI_1024_0_BASEADDR
+ */
+#define MONT1024_BASE   XPAR_MONTGOMERY_AXI_1024_0_BASEADDR
+
+/* done interrupts on IRQ_F2P[0] / IRQ_F2P[1] (GIC IDs 61 / 62) */
+#ifdef XPAR_FABRIC_MONTGOMERY_AXI_0_IRQ_INTR
+#define MONT2048_IRQ    XPAR_FABRIC_MONTGOMERY_AXI_0_IRQ_INTR
+#else
+#define MONT2048_IRQ    61U
+#endif
+#ifdef XPAR_FABRIC_MONTGOMERY_AXI_1024_0_IRQ_INTR
+#define MONT1024_IRQ    XPAR_FABRIC_MONTGOMERY_AXI_1024_0_IRQ_INTR
+#else
+#define MONT1024_IRQ    62U
+#endif
+#endif
+
+static u32 core_nwords(mont_core_id_t core)
+{
+    return (core == MONT_CORE_1024) ? NWORDS_1024 : NWORDS_2048;
+}
+
+static int open_done(mont_dev_t *dev, int ok)
+{
+    dev->varlen   = 0U;
+    if (ok)
+        dev->varlen = (dev->ops->read_reg(dev, REG_HWCFG) & HWCFG_VARLEN) != 0U;
+    dev->irq_on   = 0U;
+    dev->irq_spin = 0U;
+    dev->slot     = 0U;
+    dev->key_tick = 0U;
+    for (u32 s = 0; s < MONT_NUM_KEYS; ++s)
+        dev->keys[s].valid = 0U;
+    return ok;
+}
+
+#if MONT_HAL_LINUX
+
+static const char *env_or(const char *name, const char *dflt)
+{
+    const char *v = getenv(name);
+    return (v != NULL && v[0] != '\0') ? v : dflt;
+}
+
+static uintptr_t core_phys(int is_1024)
+{
+    const char *phys = getenv(is_1024 ? "MONT_PHYS_1024" : "MONT_PHYS_2048");
+
+    if (phys != NULL && phys[0] != '\0')
+        return (uintptr_t)strtoul(phys, NULL, 0);
+    return is_1024 ? MONT1024_PHYS : MONT2048_PHYS;
+}
+
+int mont_hal_open(mont_dev_t *dev, mont_core_id_t core)
+{
+    static char uio_path[2][32];
+    int       is_1024  = (core == MONT_CORE_1024);
+    uintptr_t addr     = core_phys(is_1024);
+    int       have_uio = mont_hal_uio_find(addr, uio_path[is_1024], sizeof(uio_path[0]));
+#if defined(__arm__)
+    /* generic-uio binding present (see zynq_petalinux): no root needed */
+    const char *backend = env_or("MONT_BACKEND", have_uio ? "uio" : "devmem");
+#else
+    const char *backend = env_or("MONT_BACKEND", "model");
+#endif
+
+    if (strcmp(backend, "model") == 0)
+        return open_done(dev, mont_hal_model_open(dev, core_nwords(core)));
+
+#if defined(MONT_HAL_VERILATOR)
+    if (strcmp(backend, "verilator") == 0)
+        return open_done(dev, mont_hal_verilator_open(dev, core_nwords(core)));
+#endif
+
+    if (strcmp(backend, "uio") == 0) {
+        const char *dflt = have_uio ? uio_path[is_1024]
+                                    : (is_1024 ? "/dev/uio1" : "/dev/uio0");
+        const char *path = env_or(is_1024 ? "MONT_UIO_1024" : "MONT_UIO_2048", dflt);
+        return open_done(dev, mont_hal_linux_open(dev, path, addr, core_nwords(core)));
+    }
+
+    if (strcmp(backend, "devmem") == 0)
+        return open_done(dev, mont_hal_linux_open(dev, "/dev/mem", addr, core_nwords(core)));
+
+    xil_printf("[ERROR] Unknown MONT_BACKEND '%s' (devmem, uio, model, verilator)\r\n", backend);
+    return 0;
+}
+
+#else /* bare metal */
+
+int mont_hal_open(mont_dev_t *dev, mont_core_id_t core)
+{
+    uintptr_t base = (core == MONT_CORE_1024) ? MONT1024_BASE : MONT2048_BASE;
+    u32 irq_id     = (core == MONT_CORE_1024) ? MONT1024_IRQ : MONT2048_IRQ;
+    return open_done(dev, mont_hal_baremetal_open(dev, base, irq_id, core_nwords(core)));
+}
+
+#endif
+
+void mont_hal_close(mont_dev_t *dev)
+{
+    if (dev->ops != NULL && dev->ops->close != NULL)
+        dev->ops->close(dev);
+    dev->ops = NULL;
+}
+
+int mont_hal_poll_done(mont_dev_t *dev, u32 max_polls)
+{
+    u32 polls = 0;
+
+    while ((dev->ops->read_reg(dev, REG_STATUS) & STATUS_DONE) == 0U) {
+        if (++polls > max_polls)
+            return 0;
+    }
+    return 1;
+}
+
+int mont_hal_irq_enable(mont_dev_t *dev, u32 spin_polls)
+{
+    if (dev->ops->irq_enable == NULL || !dev->ops->irq_enable(dev))
+        return 0;
+
+    mont_hal_write_reg(dev, REG_IRQ_STATUS, IRQ_DONE);
+    mont_hal_write_reg(dev, REG_IRQ_ENABLE, IRQ_DONE);
+    dev->irq_spin = spin_polls;
+    dev->irq_on   = 1U;
+    return 1;
+}
+
+int mont_hal_irq_wait_done(mont_dev_t *dev, u32 max_polls)
+{
+    u32 polls = 0;
+    int ok    = 1;
+
+    while ((dev->ops->read_reg(dev, REG_STATUS) & STATUS_DONE) == 0U) {
+        if (polls < dev->irq_spin) {
+            /* short jobs finish before a sleep would pay off */
+            if (++polls > max_polls) {
+                ok = 0;
+                break;
+            }
+        } else if (!dev->ops->irq_wait(dev, MONT_IRQ_TIMEOUT_MS)) {
+            ok = 0;
+            break;
+        }
+    }
+
+    /* irq is a level: drop it before the next job can finish */
+    dev->ops->write_reg(dev, REG_IRQ_STATUS, IRQ_DONE);
+    return ok;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Key slots                                                                  */
+/* -------------------------------------------------------------------------- */
+
+/* free slot first, else least recently used */
+static u32 key_victim(mont_dev_t *dev)
+{
+    u32 victim = 0U;
+
+    for (u32 s = 0; s < MONT_NUM_KEYS; ++s) {
+        if (!dev->keys[s].valid)
+            return s;
+        if (dev->keys[s].last_use < dev->keys[victim].last_use)
+            victim = s;
+    }
+    return victim;
+}
+
+int mont_hal_width_ok(const mont_dev_t *dev, u32 nwords)
+{
+    if (nwords == dev->nwords)
+        return 1;
+    return dev->varlen && nwords != 0U && nwords < dev->nwords &&
+           (nwords % 16U) == 0U;
+}
+
+u32 mont_hal_key_load(mont_dev_t *dev, u32 nwords, const u32 *N,
+                      const u32 *R2, u32 nprime, u32 bits)
+{
+    u32 victim;
+
+    ++dev->key_tick;
+
+    for (u32 s = 0; s < MONT_NUM_KEYS; ++s) {
+        mont_key_slot_t *k = &dev->keys[s];
+        if (k->valid && k->nwords == nwords && bigint_equal(k->n, N, nwords)) {
+            k->last_use = dev->key_tick;
+            dev->slot   = s;            /* no bus traffic on a hit */
+            return s;
+        }
+    }
+
+    victim    = key_victim(dev);
+    dev->slot = victim;
+    mont_hal_control(dev, 0U);
+    mont_hal_write_reg(dev, REG_KEY_LEN, 32U * nwords);
+    mont_hal_write_block(dev, REG_N(0),  N,  nwords);
+    mont_hal_write_block(dev, REG_R2(0), R2, nwords);
+    mont_hal_write_reg(dev, REG_NPRIME,   nprime);
+    mont_hal_write_reg(dev, REG_KEY_BITS, bits);
+
+    bigint_copy(dev->keys[victim].n, N, nwords);
+    dev->keys[victim].nwords   = nwords;
+    dev->keys[victim].valid    = 1U;
+    dev->keys[victim].last_use = dev->key_tick;
+    return victim;
+}
+
+u32 mont_hal_key_scratch(mont_dev_t *dev, u32 nwords)
+{
+    u32 victim = key_victim(dev);
+
+    dev->keys[victim].valid = 0U;
+    dev->slot = victim;
+    mont_hal_control(dev, 0U);
+    mont_hal_write_reg(dev, REG_KEY_LEN, 32U * nwords);
+    return victim;
+}
+
+/* -------------------------------------------------------------------------- */
+/* DMA buffers                                                                */
+/* -------------------------------------------------------------------------- */
+
+void *mont_hal_dma_alloc(mont_dev_t *dev, u32 bytes, u32 *phys)
+{
+    if (dev->ops->dma_alloc == NULL ||
+        (dev->ops->read_reg(dev, REG_HWCFG) & HWCFG_DMA) == 0U)
+        return NULL;
+
+    /* whole cache lines, so syncing one buffer never touches another */
+    return dev->ops->dma_alloc(dev, (bytes + 31U) & ~31U, phys);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Descriptor ring                                                            */
+/* -------------------------------------------------------------------------- */
+
+int mont_hal_ring_init(mont_dev_t *dev, mont_ring_t *ring, u32 size)
+{
+    if (size < 2U || size > 0xFFFFU)
+        return 0;
+    ring->desc = (mont_dma_desc_t *)mont_hal_dma_alloc(dev,
+                     size * (u32)sizeof(mont_dma_desc_t), &ring->phys);
+    if (ring->desc == NULL)
+        return 0;
+
+    ring->size    = size;
+    ring->tail    = 0U;
+    ring->hw_tail = 0U;
+    ring->head    = 0U;
+    mont_hal_write_reg(dev, REG_RING_BASE, ring->phys);
+    mont_hal_write_reg(dev, REG_RING_SIZE, size);   /* head = tail = 0 */
+    return 1;
+}
+
+mont_dma_desc_t *mont_hal_ring_next(mont_ring_t *ring)
+{
+    u32 next = (ring->tail + 1U == ring->size) ? 0U : ring->tail + 1U;
+    mont_dma_desc_t *d;
+
+    if (next == ring->head)
+        return NULL;
+    d = &ring->desc[ring->tail];
+    d->done    = 0U;
+    ring->tail = next;
+    return d;
+}
+
+void mont_hal_ring_doorbell(mont_dev_t *dev, mont_ring_t *ring)
+{
+    if (ring->hw_tail == ring->tail)
+        return;
+    while (ring->hw_tail != ring->tail) {
+        mont_hal_dma_sync(dev, &ring->desc[ring->hw_tail],
+                          (u32)sizeof(mont_dma_desc_t), 1);
+        ring->hw_tail = (ring->hw_tail + 1U == ring->size) ? 0U : ring->hw_tail + 1U;
+    }
+    mont_hal_write_reg(dev, REG_RING_TAIL, ring->tail);
+}
+
+u32 mont_hal_ring_reap(mont_dev_t *dev, mont_ring_t *ring, u32 max_polls)
+{
+    mont_dma_desc_t *d = &ring->desc[ring->head];
+    u32 polls = 0;
+    u32 done;
+
+    if (ring->head == ring->hw_tail)
+        return 0U;
+
+    /* with several lanes a later entry may finish first, so RING_HEAD
+     * (a count) says nothing about ours: poll its own done word. The
+     * register read paces the loop and keeps simulated backends running. */
+    for (;;) {
+        mont_hal_dma_sync(dev, d, (u32)sizeof(mont_dma_desc_t), 0);
+        done = d->done;
+        if (done & RING_DONE)
+            break;
+        if (++polls > max_polls)
+            return 0U;
+        (void)mont_hal_read_reg(dev, REG_RING_HEAD);
+    }
+
+    ring->head = (ring->head + 1U == ring->size) ? 0U : ring->head + 1U;
+    return done;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Timer                                                                      */
+/* -------------------------------------------------------------------------- */
+
+#if MONT_HAL_LINUX
+
+void Timer_Init(void)
+{
+    xil_printf("[INFO] Using CLOCK_MONOTONIC, freq %u Hz\r\n", 1000000000U);
+}
+
+u64 Timer_GetCount(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+}
+
+u64 Timer_GetFreqHz(void)
+{
+    return 1000000000ULL;
+}
+
+#else /* Zynq ARM global timer */
+
+#define GTIMER_BASE     0xF8F00200U
+#define GTIMER_CTRL     (GTIMER_BASE + 0x08U)
+
+/* Approximate frequency in Hz (adjust if you know exact value) */
+#define GTIMER_FREQ_HZ  650000000U
+
+void Timer_Init(void)
+{
+    /* enable global timer (bit 0 = EN) */
+    u32 ctrl = Xil_In32(GTIMER_CTRL);
+    ctrl |= 0x1U;
+    Xil_Out32(GTIMER_CTRL, ctrl);
+
+    xil_printf("[INFO] Global timer enabled, freq ~%u Hz\r\n",
+               (unsigned)GTIMER_FREQ_HZ);
+}
+
+u64 Timer_GetCount(void)
+{
+    u32 low, high0, high1;
+    do {
+        high0 = Xil_In32(GTIMER_BASE + 0x04U);
+        low   = Xil_In32(GTIMER_BASE + 0x00U);
+        high1 = Xil_In32(GTIMER_BASE + 0x04U);
+    } while (high0 != high1);
+    return ((u64)high1 << 32) | (u64)low;
+}
+
+u64 Timer_GetFreqHz(void)
+{
+    return (u64)GTIMER_FREQ_HZ;
+}
+
+#endif
@@ -0,0 +1,329 @@
+/* -------------------------------------------------------------------------- */
+/* mont_hal.h                                                                 */
+/* Hardware abstraction layer for the Montgomery accelerators                */
+/*                                                                            */
+/* Everything above this layer (montgomery_mul_hw, modexp, benchmarks) talks  */
+/* to a mont_dev_t; the backend behind it decides whether register accesses   */
+/* go to the AXI bus (bare metal), to an mmap'ed window (Linux /dev/mem or    */
+/* UIO) or to a software model of montgomery_axi (host builds).               */
+/* -------------------------------------------------------------------------- */
+#ifndef MONT_HAL_H
+#define MONT_HAL_H
+
+#include <stdint.h>
+#include "mont_sw.h"
+
+#if defined(__linux__)
+#define MONT_HAL_LINUX  1
+#include <stdio.h>
+#define xil_printf      printf
+#else
+#define MONT_HAL_LINUX  0
+#include "xil_printf.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* AXI register layout (byte offsets) – must match montgomery_axi.v          */
+/* -------------------------------------------------------------------------- */
+
+#define REG_A(i)            (0x000U + 4U*(i))   /* write-only */
+#define REG_B(i)            (0x200U + 4U*(i))   /* write-only */
+#define REG_N(i)            (0x400U + 4U*(i))   /* key slot, write-only */
+#define REG_RES(i)          (0x600U + 4U*(i))
+#define REG_NPRIME          0x800U              /* key slot */
+#define REG_CONTROL         0x804U
+#define REG_STATUS          0x808U
+#define REG_CYCLES          0x80CU      /* core clocks of the bank's last job */
+#define REG_EXP_BITS        0x810U      /* modexp: exponent length in bits */
+#define REG_KEY_BITS        0x814U      /* key slot: modulus length in bits */
+#define REG_IRQ_ENABLE      0x818U
+#define REG_IRQ_STATUS      0x81CU      /* write 1 to clear */
+#define REG_DMA_DESC        0x820U      /* descriptor address for CONTROL.dma */
+#define REG_HWCFG           0x824U      /* read-only build parameters */
+#define REG_RING_BASE       0x828U      /* descriptor ring, 32-byte entries */
+#define REG_RING_SIZE       0x82CU      /* entries, 0: off; a write restarts it */
+#define REG_RING_TAIL       0x830U      /* doorbell: index after the last posted entry */
+#define REG_RING_HEAD       0x834U      /* entries completed, mod RING_SIZE (read-only) */
+#define REG_LANE_STATUS     0x838U      /* [7:0] lane busy, [15:8] waiting for DMA */
+#define REG_LANE_BANK       0x83CU      /* operand bank of each lane, 4 bits each */
+#define REG_KEY_LEN         0x840U      /* key slot: operand length, R = 2^KEY_LEN */
+#define REG_EXP(i)          (0xA00U + 4U*(i))
+#define REG_R2(i)           (0xC00U + 4U*(i))   /* key slot, write-only */
+
+#define CONTROL_START       0x1U
+#define CONTROL_MODEXP      0x2U        /* with START: RES = A^EXP mod N */
+#define CONTROL_BANK1       0x4U        /* windows (and START) use operand bank 1 */
+                                        /* banks 2..7: bits 20:18, NUM_LANES > 1 */
+#define CONTROL_DMA         0x8U        /* with START: operands via REG_DMA_DESC */
+#define CONTROL_BANK(b)     ((((u32)(b) & 1U) << 2) | (((u32)(b) >> 1) << 18))
+#define CONTROL_SLOT(s)     (((u32)(s) & 0xFU) << 4)    /* key slot */
+#define CONTROL_ASRC(x)     (((u32)(x) & 0x7U) << 8)    /* plain product operand */
+#define CONTROL_BSRC(x)     (((u32)(x) & 0x7U) << 12)   /*   sources, MONT_SRC_* */
+#define CONTROL_DST(x)      (((u32)(x) & 0x3U) << 16)   /* result copy, MONT_DST_* */
+#define STATUS_DONE         0x1U        /* job on the selected bank finished */
+#define STATUS_BUSY         0x2U
+#define STATUS_QUEUED       0x4U        /* a second START is waiting */
+#define STATUS_DMA_ERR      0x8U        /* last job hit an AXI error on m_axi */
+#define HWCFG_DMA           0x01000000U /* built with DMA_EN */
+#define HWCFG_LANES(v)      ((((v) >> 25) & 0x7U) + 1U) /* NUM_LANES, 2 banks each */
+#define HWCFG_VARLEN        0x10000000U /* KEY_LEN takes multiples of 512 bits */
+#define HWCFG_CORE_CLK      0x20000000U /* cores on their own core_clk */
+#define IRQ_DONE            0x1U        /* IRQ_ENABLE / IRQ_STATUS: a job finished */
+#define IRQ_RING            0x2U        /*   a ring entry completed */
+#define RING_DONE           0x1U        /* mont_dma_desc_t.done, written by the core */
+#define RING_ERR            0x2U        /*   with RING_DONE: bus error, no result */
+
+/* CONTROL.asrc / bsrc */
+#define MONT_SRC_MEM        0U          /* A / B window */
+#define MONT_SRC_RES        1U          /* result of the previous product */
+#define MONT_SRC_X0         2U
+#define MONT_SRC_X1         3U
+#define MONT_SRC_ONE        4U
+#define MONT_SRC_R2         5U          /* R^2 mod N of the key slot */
+
+/* CONTROL.dst (X0 / X1 are also the modexp sequencer's x and a) */
+#define MONT_DST_NONE       0U
+#define MONT_DST_X0         1U
+#define MONT_DST_X1         2U
+
+#define MONT_REG_SPAN       0x1000U     /* 4 KB register window */
+
+#define MONT_NUM_KEYS       4U          /* montgomery_axi NUM_KEYS */
+
+#define MONT_IRQ_TIMEOUT_MS 5000U       /* longest single block on the interrupt */
+
+/* CONTROL.dma / ring descriptor, 32 bytes in DMA memory. Addresses are
+ * physical; 0 skips the transfer (operand already on chip / result only in
+ * RES). ctrl and exp_bits are only read for ring entries, CONTROL.dma jobs
+ * take them from CONTROL and REG_EXP_BITS. */
+typedef struct {
+    u32 ctrl;                           /* CONTROL_MODEXP, _SLOT, _ASRC, _BSRC, _DST */
+    u32 a_addr;
+    u32 b_addr;                         /* exponent for modexp */
+    u32 n_addr;                         /* loads N into the job's key slot */
+    u32 res_addr;
+    u32 nprime;                         /* used with n_addr */
+    u32 exp_bits;
+    u32 done;                           /* ring: 0 when posted, RING_DONE [| RING_ERR] */
+} mont_dma_desc_t;
+
+/* Descriptor ring: the driver fills entries at tail, rings the doorbell and
+ * reaps them at head; with more than one lane the core may complete them
+ * out of order, the driver still reaps in order */
+typedef struct {
+    mont_dma_desc_t *desc;
+    u32              phys;
+    u32              size;              /* entries, one always stays free */
+    u32              tail;              /* next entry to fill */
+    u32              hw_tail;           /* tail as last written to REG_RING_TAIL */
+    u32              head;              /* oldest entry not reaped yet */
+} mont_ring_t;
+
+/* -------------------------------------------------------------------------- */
+/* Device handle                                                              */
+/* -------------------------------------------------------------------------- */
+
+typedef struct mont_dev mont_dev_t;
+
+/* driver's record of what is loaded in one key slot */
+typedef struct {
+    u32 valid;
+    u32 last_use;                       /* LRU stamp */
+    u32 nwords;                         /* KEY_LEN / 32 */
+    u32 n[MAX_WORDS];
+} mont_key_slot_t;
+
+typedef struct {
+    void (*write_block)(mont_dev_t *dev, u32 off, const u32 *src, u32 nwords);
+    void (*read_block)(mont_dev_t *dev, u32 off, u32 *dst, u32 nwords);
+    void (*write_reg)(mont_dev_t *dev, u32 off, u32 val);
+    u32  (*read_reg)(mont_dev_t *dev, u32 off);
+    /* returns 1 when STATUS.done is set, 0 after max_polls */
+    int  (*wait_done)(mont_dev_t *dev, u32 max_polls);
+    void (*close)(mont_dev_t *dev);
+    /* accelerator clock cycles elapsed so far (simulation backends only) */
+    u64  (*cycles)(mont_dev_t *dev);
+    /* hook up the done interrupt, returns 1 when irq_wait can be used
+     * (NULL: backend has no interrupt) */
+    int  (*irq_enable)(mont_dev_t *dev);
+    /* sleep until the interrupt fires; 0 on timeout or error. May return
+     * early for an interrupt that was already taken, callers recheck STATUS */
+    int  (*irq_wait)(mont_dev_t *dev, u32 timeout_ms);
+    /* memory the m_axi master can reach; NULL when out of space or the
+     * backend has none. Never freed, the pool lives as long as the process */
+    void *(*dma_alloc)(mont_dev_t *dev, u32 bytes, u32 *phys);
+    /* hand a buffer to the accelerator (to_dev) or back to the CPU */
+    void (*dma_sync)(mont_dev_t *dev, void *buf, u32 bytes, int to_dev);
+} mont_hal_ops_t;
+
+struct mont_dev {
+    const mont_hal_ops_t *ops;
+    const char           *backend;     /* "baremetal", "devmem", "uio", "model", "verilator" */
+    u32                   nwords;      /* core width: N_BITS / 32 */
+    u32                   varlen;      /* HWCFG_VARLEN: shorter keys run too */
+    uintptr_t             base;        /* physical base address (0 for model) */
+    volatile u32         *regs;        /* mapped register window (Linux) */
+    void                 *priv;        /* backend-private state */
+    u32                   irq_on;      /* waits block on the done interrupt */
+    u32                   irq_spin;    /* STATUS polls before blocking */
+    u32                   slot;        /* key slot used by CONTROL writes */
+    u32                   key_tick;
+    mont_key_slot_t       keys[MONT_NUM_KEYS];
+};
+
+/* Accelerator instances in the PYNQ-Z2 block design */
+typedef enum {
+    MONT_CORE_2048 = 0,     /* montgomery_axi_0      */
+    MONT_CORE_1024 = 1      /* montgomery_axi_1024_0 */
+} mont_core_id_t;
+
+/* Open the platform default backend for a core:
+ *   bare metal : Xil_Out32/Xil_In32 at the XPAR base address
+ *   Linux      : selected by $MONT_BACKEND = devmem | uio | model | verilator
+ *                (default devmem on ARM, model elsewhere; verilator only
+ *                when built with -DMONT_HAL_VERILATOR, see sim/)
+ * Returns 1 on success. */
+int  mont_hal_open(mont_dev_t *dev, mont_core_id_t core);
+void mont_hal_close(mont_dev_t *dev);
+
+/* Backend constructors (return 1 on success) */
+int  mont_hal_baremetal_open(mont_dev_t *dev, uintptr_t base, u32 irq_id, u32 nwords);
+int  mont_hal_linux_open(mont_dev_t *dev, const char *path, uintptr_t phys, u32 nwords);
+int  mont_hal_model_open(mont_dev_t *dev, u32 nwords);
+int  mont_hal_verilator_open(mont_dev_t *dev, u32 nwords);
+
+/* Linux: find the /dev/uioN whose map 0 starts at phys (sysfs scan).
+ * Returns 1 and the device path in path on success. */
+int  mont_hal_uio_find(uintptr_t phys, char *path, u32 len);
+
+/* Shared STATUS polling loop for backends without a better wait */
+int  mont_hal_poll_done(mont_dev_t *dev, u32 max_polls);
+
+/* Switch waits to spin-then-block: poll STATUS up to spin_polls times, then
+ * sleep on the done interrupt. Returns 0 (and keeps polling) when the
+ * backend has no interrupt. */
+int  mont_hal_irq_enable(mont_dev_t *dev, u32 spin_polls);
+
+/* The spin-then-block wait behind mont_hal_wait_done() once enabled */
+int  mont_hal_irq_wait_done(mont_dev_t *dev, u32 max_polls);
+
+/* 1 when the core can run nwords-word keys: its own width, or on a varlen
+ * core any multiple of 16 words below it */
+int  mont_hal_width_ok(const mont_dev_t *dev, u32 nwords);
+
+/* Make the nwords-word key (N, R^2 mod N, n') current: reuse the slot that
+ * already holds N at that length, otherwise upload it (and KEY_LEN) into a
+ * free or the least recently used slot. nwords must pass
+ * mont_hal_width_ok(). Must not evict a slot a running or queued job uses.
+ * Returns the slot; an upload leaves bank 0 selected. */
+u32  mont_hal_key_load(mont_dev_t *dev, u32 nwords, const u32 *N,
+                       const u32 *R2, u32 nprime, u32 bits);
+
+/* Make the least recently used slot current for nwords-word operands and
+ * forget what it held, for a DMA job that brings its own N (R^2 of that
+ * slot is then stale). Leaves bank 0 selected. */
+u32  mont_hal_key_scratch(mont_dev_t *dev, u32 nwords);
+
+/* 32-byte aligned DMA buffer, NULL if the core was built without DMA_EN or
+ * the backend cannot provide one */
+void *mont_hal_dma_alloc(mont_dev_t *dev, u32 bytes, u32 *phys);
+
+/* Allocate a ring of size entries and hand it to the core. Returns 0 without
+ * DMA_EN or DMA memory. Ring jobs use all operand banks: no START of its
+ * own while entries are outstanding. */
+int  mont_hal_ring_init(mont_dev_t *dev, mont_ring_t *ring, u32 size);
+
+/* Next entry to fill (done already cleared), NULL when the ring is full.
+ * The core sees it after the next doorbell. */
+mont_dma_desc_t *mont_hal_ring_next(mont_ring_t *ring);
+
+/* Publish every entry filled since the last doorbell */
+void mont_hal_ring_doorbell(mont_dev_t *dev, mont_ring_t *ring);
+
+/* Wait for the oldest outstanding entry and return its done word, 0 after
+ * max_polls of its done word or with nothing outstanding. The caller syncs
+ * the result buffer. */
+u32  mont_hal_ring_reap(mont_dev_t *dev, mont_ring_t *ring, u32 max_polls);
+
+/* -------------------------------------------------------------------------- */
+/* Driver-facing helpers                                                      */
+/* -------------------------------------------------------------------------- */
+
+static inline void mont_hal_write_block(mont_dev_t *dev, u32 off,
+                                        const u32 *src, u32 nwords)
+{
+    dev->ops->write_block(dev, off, src, nwords);
+}
+
+static inline void mont_hal_read_block(mont_dev_t *dev, u32 off,
+                                       u32 *dst, u32 nwords)
+{
+    dev->ops->read_block(dev, off, dst, nwords);
+}
+
+static inline void mont_hal_write_reg(mont_dev_t *dev, u32 off, u32 val)
+{
+    dev->ops->write_reg(dev, off, val);
+}
+
+static inline u32 mont_hal_read_reg(mont_dev_t *dev, u32 off)
+{
+    return dev->ops->read_reg(dev, off);
+}
+
+/* CONTROL write with the current key slot (dev->slot) */
+static inline void mont_hal_control(mont_dev_t *dev, u32 bits)
+{
+    dev->ops->write_reg(dev, REG_CONTROL, bits | CONTROL_SLOT(dev->slot));
+}
+
+static inline void mont_hal_start(mont_dev_t *dev)
+{
+    mont_hal_control(dev, CONTROL_START);
+}
+
+static inline int mont_hal_wait_done(mont_dev_t *dev, u32 max_polls)
+{
+    if (dev->irq_on)
+        return mont_hal_irq_wait_done(dev, max_polls);
+    return dev->ops->wait_done(dev, max_polls);
+}
+
+static inline void mont_hal_dma_sync(mont_dev_t *dev, void *buf, u32 bytes,
+                                     int to_dev)
+{
+    if (dev->ops->dma_sync != NULL)
+        dev->ops->dma_sync(dev, buf, bytes, to_dev);
+}
+
+/* 0 when the backend cannot count accelerator clocks */
+static inline u64 mont_hal_cycles(mont_dev_t *dev)
+{
+    return (dev->ops->cycles != NULL) ? dev->ops->cycles(dev) : 0ULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Timer                                                                      */
+/*   bare metal : Zynq global timer                                           */
+/*   Linux      : clock_gettime(CLOCK_MONOTONIC), 1 tick = 1 ns               */
+/* -------------------------------------------------------------------------- */
+
+void Timer_Init(void);
+u64  Timer_GetCount(void);
+u64  Timer_GetFreqHz(void);
+
+static inline u64 Timer_Delta(u64 start, u64 end)
+{
+    if (end >= start) return end - start;
+    return (0xFFFFFFFFFFFFFFFFULL - start) + 1ULL + end;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MONT_HAL_H */
@@ -0,0 +1,241 @@
+/* -------------------------------------------------------------------------- */
+/* mont_hal_baremetal.c                                                       */
+/* Standalone BSP backend: direct Xil_Out32/Xil_In32 on the AXI GP port      */
+/*                                                                            */
+/* The done interrupt goes through the SCU GIC; a blocked wait sleeps in WFI. */
+/* The global timer comparator (the Timer_GetCount() clock) is armed for the  */
+/* deadline first, so a hung core still wakes the CPU and times out.          */
+/*                                                                            */
+/* DMA buffers come from a static pool in DDR; the HP ports are not coherent, */
+/* so the data cache is flushed / invalidated around every job.              */
+/* -------------------------------------------------------------------------- */
+#include "mont_hal.h"
+
+#if !MONT_HAL_LINUX
+
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xil_exception.h"
+#include "xparameters.h"
+#include "xscugic.h"
+
+typedef struct {
+    u32          in_use;        /* slot taken, cleared by bm_close */
+    u32          irq_id;
+    volatile u32 irq_seen;      /* set by bm_isr, cleared by bm_irq_wait */
+} bm_priv_t;
+
+#define BM_MAX_DEVS 4
+static bm_priv_t bm_priv[BM_MAX_DEVS];
+
+static XScuGic   bm_gic;
+static int       bm_gic_ready;
+
+/* ARM global timer comparator, interrupt 27 (PPI) */
+#define BM_GT_BASE          0xF8F00200U
+#define BM_GT_CTRL          (BM_GT_BASE + 0x08U)
+#define BM_GT_ISR           (BM_GT_BASE + 0x0CU)
+#define BM_GT_CMP_LO        (BM_GT_BASE + 0x10U)
+#define BM_GT_CMP_HI        (BM_GT_BASE + 0x14U)
+#define BM_GT_CTRL_CMP      0x6U                /* comparator + its IRQ */
+#define BM_GT_IRQ_ID        27U
+
+#define BM_DMA_POOL_WORDS   (16U * 1024U)       /* 64 KB */
+static u32       bm_dma_pool[BM_DMA_POOL_WORDS] __attribute__((aligned(32)));
+static u32       bm_dma_used;                   /* words */
+
+static void bm_write_block(mont_dev_t *dev, u32 off, const u32 *src, u32 nwords)
+{
+    for (u32 i = 0; i < nwords; ++i)
+        Xil_Out32(dev->base + off + 4U*i, src[i]);
+}
+
+static void bm_read_block(mont_dev_t *dev, u32 off, u32 *dst, u32 nwords)
+{
+    for (u32 i = 0; i < nwords; ++i)
+        dst[i] = Xil_In32(dev->base + off + 4U*i);
+}
+
+static void bm_write_reg(mont_dev_t *dev, u32 off, u32 val)
+{
+    Xil_Out32(dev->base + off, val);
+}
+
+static u32 bm_read_reg(mont_dev_t *dev, u32 off)
+{
+    return Xil_In32(dev->base + off);
+}
+
+static void bm_isr(void *ref)
+{
+    mont_dev_t *dev = (mont_dev_t *)ref;
+    bm_priv_t  *bp  = (bm_priv_t *)dev->priv;
+
+    /* level interrupt: clear it at the source before returning */
+    Xil_Out32(dev->base + REG_IRQ_STATUS, IRQ_DONE);
+    bp->irq_seen = 1U;
+}
+
+/* wait deadline reached: the wake-up is all that was needed */
+static void bm_gt_isr(void *ref)
+{
+    (void)ref;
+    Xil_Out32(BM_GT_CTRL, Xil_In32(BM_GT_CTRL) & ~BM_GT_CTRL_CMP);
+    Xil_Out32(BM_GT_ISR, 1U);
+}
+
+static int bm_gic_init(void)
+{
+    XScuGic_Config *cfg;
+
+    if (bm_gic_ready)
+        return 1;
+
+    cfg = XScuGic_LookupConfig(XPAR_SCUGIC_SINGLE_DEVICE_ID);
+    if (cfg == NULL ||
+        XScuGic_CfgInitialize(&bm_gic, cfg, cfg->CpuBaseAddress) != XST_SUCCESS) {
+        xil_printf("[ERROR] GIC initialisation failed\r\n");
+        return 0;
+    }
+
+    XScuGic_SetPriorityTriggerType(&bm_gic, BM_GT_IRQ_ID, 0xA0U, 0x3U);
+    if (XScuGic_Connect(&bm_gic, BM_GT_IRQ_ID, bm_gt_isr, NULL) != XST_SUCCESS) {
+        xil_printf("[ERROR] Cannot connect global timer IRQ\r\n");
+        return 0;
+    }
+    XScuGic_Enable(&bm_gic, BM_GT_IRQ_ID);
+
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+                                 (Xil_ExceptionHandler)XScuGic_InterruptHandler,
+                                 &bm_gic);
+    Xil_ExceptionEnable();
+    bm_gic_ready = 1;
+    return 1;
+}
+
+static int bm_irq_enable(mont_dev_t *dev)
+{
+    bm_priv_t *bp = (bm_priv_t *)dev->priv;
+
+    if (!bm_gic_init())
+        return 0;
+
+    /* priority 0xA0, trigger 0x1 = active-high level */
+    XScuGic_SetPriorityTriggerType(&bm_gic, bp->irq_id, 0xA0U, 0x1U);
+    if (XScuGic_Connect(&bm_gic, bp->irq_id, bm_isr, dev) != XST_SUCCESS) {
+        xil_printf("[ERROR] Cannot connect IRQ %u\r\n", (unsigned)bp->irq_id);
+        return 0;
+    }
+    XScuGic_Enable(&bm_gic, bp->irq_id);
+    return 1;
+}
+
+static int bm_irq_wait(mont_dev_t *dev, u32 timeout_ms)
+{
+    bm_priv_t *bp    = (bm_priv_t *)dev->priv;
+    u64        limit = (Timer_GetFreqHz() / 1000ULL) * timeout_ms;
+    u64        start = Timer_GetCount();
+    u64        deadline = start + limit;
+    int        seen;
+
+    /* wake-up at the deadline, armed before the first timeout check so the
+     * comparator is always still ahead of the counter when we sleep */
+    Xil_Out32(BM_GT_CTRL, Xil_In32(BM_GT_CTRL) & ~BM_GT_CTRL_CMP);
+    Xil_Out32(BM_GT_ISR, 1U);
+    Xil_Out32(BM_GT_CMP_LO, (u32)deadline);
+    Xil_Out32(BM_GT_CMP_HI, (u32)(deadline >> 32));
+    Xil_Out32(BM_GT_CTRL, Xil_In32(BM_GT_CTRL) | BM_GT_CTRL_CMP);
+
+    /* WFI with IRQs masked still wakes on a pending interrupt, so one that
+     * fires between the check and the WFI is not lost */
+    Xil_ExceptionDisable();
+    while (!bp->irq_seen) {
+        if (Timer_Delta(start, Timer_GetCount()) > limit)
+            break;
+        __asm__ volatile ("wfi");
+        Xil_ExceptionEnable();      /* let the handler run */
+        Xil_ExceptionDisable();
+    }
+    seen = (int)bp->irq_seen;
+    bp->irq_seen = 0U;
+    Xil_Out32(BM_GT_CTRL, Xil_In32(BM_GT_CTRL) & ~BM_GT_CTRL_CMP);
+    Xil_Out32(BM_GT_ISR, 1U);
+    Xil_ExceptionEnable();
+    return seen;
+}
+
+static void bm_close(mont_dev_t *dev)
+{
+    bm_priv_t *bp = (bm_priv_t *)dev->priv;
+
+    /* a later open may reuse the slot with another IRQ ID */
+    if (bm_gic_ready) {
+        XScuGic_Disable(&bm_gic, bp->irq_id);
+        XScuGic_Disconnect(&bm_gic, bp->irq_id);
+    }
+    bp->in_use = 0U;
+}
+
+static void *bm_dma_alloc(mont_dev_t *dev, u32 bytes, u32 *phys)
+{
+    u32 *p;
+
+    (void)dev;
+    if (bytes / 4U > BM_DMA_POOL_WORDS - bm_dma_used)
+        return NULL;
+    p = &bm_dma_pool[bm_dma_used];
+    bm_dma_used += bytes / 4U;
+    *phys = (u32)(uintptr_t)p;      /* flat mapping, CPU and HP agree */
+    return p;
+}
+
+static void bm_dma_sync(mont_dev_t *dev, void *buf, u32 bytes, int to_dev)
+{
+    (void)dev;
+    if (to_dev)
+        Xil_DCacheFlushRange((INTPTR)buf, bytes);
+    else
+        Xil_DCacheInvalidateRange((INTPTR)buf, bytes);
+}
+
+static const mont_hal_ops_t bm_ops = {
+    bm_write_block,
+    bm_read_block,
+    bm_write_reg,
+    bm_read_reg,
+    mont_hal_poll_done,
+    bm_close,
+    NULL,
+    bm_irq_enable,
+    bm_irq_wait,
+    bm_dma_alloc,
+    bm_dma_sync
+};
+
+int mont_hal_baremetal_open(mont_dev_t *dev, uintptr_t base, u32 irq_id, u32 nwords)
+{
+    bm_priv_t *bp;
+    u32 i;
+
+    for (i = 0; i < BM_MAX_DEVS && bm_priv[i].in_use; ++i)
+        ;
+    if (i == BM_MAX_DEVS) {
+        xil_printf("[ERROR] Too many open Montgomery devices\r\n");
+        return 0;
+    }
+    bp = &bm_priv[i];
+    bp->in_use   = 1U;
+    bp->irq_id   = irq_id;
+    bp->irq_seen = 0U;
+
+    dev->ops     = &bm_ops;
+    dev->backend = "baremetal";
+    dev->nwords  = nwords;
+    dev->base    = base;
+    dev->regs    = NULL;
+    dev->priv    = bp;
+    return 1;
+}
+
+#endif /* !MONT_HAL_LINUX */
@@ -0,0 +1,274 @@
+/* -------------------------------------------------------------------------- */
+/* mont_hal_linux.c                                                           */
+/* Linux backend: mmap the 4 KB register window through /dev/mem or UIO     */
+/*                                                                            */
+/*   /dev/mem  : phys = AXI base address of the IP block (needs root)         */
+/*   /dev/uioN : phys ignored, map 0 of the UIO device is used                */
+/*                                                                            */
+/* With UIO the done interrupt is available too: uio_pdrv_genirq masks the    */
+/* line when it fires, writing 1 to the fd unmasks it and read() blocks until */
+/* the next one.                                                              */
+/*                                                                            */
+/* DMA buffers live in the reserved-memory carve-out of system-user.dtsi:    */
+/* map 1 of the UIO device, or /dev/mem at $MONT_DMA_PHYS. Both mappings are  */
+/* O_SYNC (uncached), so a sync is only a barrier.                            */
+/* -------------------------------------------------------------------------- */
+#include "mont_hal.h"
+
+#if MONT_HAL_LINUX
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+typedef struct {
+    int   in_use;                       /* slot taken, cleared by lx_close */
+    int   fd;
+    int   is_uio;
+    void *map;
+    char  path[32];
+} linux_priv_t;
+
+#define LX_DMA_PHYS     0x1FF00000U     /* reserved-memory in system-user.dtsi */
+#define LX_DMA_SPAN     0x00100000U     /* 1 MB */
+
+/* one pool for all devices, mapped on first use */
+static u32 *lx_dma_map;
+static u32  lx_dma_phys;
+static u32  lx_dma_size;
+static u32  lx_dma_used;
+
+static void lx_write_block(mont_dev_t *dev, u32 off, const u32 *src, u32 nwords)
+{
+    volatile u32 *p = dev->regs + off / 4U;
+    for (u32 i = 0; i < nwords; ++i)
+        p[i] = src[i];
+}
+
+static void lx_read_block(mont_dev_t *dev, u32 off, u32 *dst, u32 nwords)
+{
+    volatile u32 *p = dev->regs + off / 4U;
+    for (u32 i = 0; i < nwords; ++i)
+        dst[i] = p[i];
+}
+
+static void lx_write_reg(mont_dev_t *dev, u32 off, u32 val)
+{
+    dev->regs[off / 4U] = val;
+}
+
+static u32 lx_read_reg(mont_dev_t *dev, u32 off)
+{
+    return dev->regs[off / 4U];
+}
+
+static int lx_irq_enable(mont_dev_t *dev)
+{
+    return ((linux_priv_t *)dev->priv)->is_uio;
+}
+
+static int lx_irq_wait(mont_dev_t *dev, u32 timeout_ms)
+{
+    linux_priv_t *lp = (linux_priv_t *)dev->priv;
+    struct pollfd pfd;
+    u32 unmask = 1U;
+    u32 count;
+
+    if (write(lp->fd, &unmask, sizeof(unmask)) != (ssize_t)sizeof(unmask))
+        return 0;
+
+    pfd.fd      = lp->fd;
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, (int)timeout_ms) <= 0)
+        return 0;
+
+    return read(lp->fd, &count, sizeof(count)) == (ssize_t)sizeof(count);
+}
+
+static void lx_close(mont_dev_t *dev)
+{
+    linux_priv_t *lp = (linux_priv_t *)dev->priv;
+
+    munmap(lp->map, MONT_REG_SPAN);
+    close(lp->fd);
+    lp->fd     = -1;
+    lp->map    = NULL;
+    lp->in_use = 0;
+    dev->regs = NULL;
+}
+
+/* /sys/class/uio/uioN/maps/mapM/<name> of the UIO device at path */
+static int lx_uio_attr(const char *path, u32 map, const char *name, unsigned long *val)
+{
+    char     sys[80];
+    char     line[32];
+    unsigned n;
+    FILE    *f;
+    int      ok = 0;
+
+    if (sscanf(path, "/dev/uio%u", &n) != 1)
+        return 0;
+    snprintf(sys, sizeof(sys), "/sys/class/uio/uio%u/maps/map%u/%s",
+             n, (unsigned)map, name);
+    f = fopen(sys, "r");
+    if (f == NULL)
+        return 0;
+    if (fgets(line, sizeof(line), f) != NULL) {
+        *val = strtoul(line, NULL, 0);
+        ok   = 1;
+    }
+    fclose(f);
+    return ok;
+}
+
+static int lx_dma_map_pool(mont_dev_t *dev)
+{
+    linux_priv_t *lp   = (linux_priv_t *)dev->priv;
+    unsigned long phys = LX_DMA_PHYS;
+    unsigned long size = LX_DMA_SPAN;
+    off_t         off;
+    void         *map;
+
+    if (lx_dma_map != NULL)
+        return 1;
+
+    if (lp->is_uio) {
+        /* mmap offset M * page size selects map M */
+        if (!lx_uio_attr(lp->path, 1U, "addr", &phys) ||
+            !lx_uio_attr(lp->path, 1U, "size", &size))
+            return 0;
+        off = (off_t)getpagesize();
+    } else {
+        const char *env = getenv("MONT_DMA_PHYS");
+        if (env != NULL && env[0] != '\0')
+            phys = strtoul(env, NULL, 0);
+        off = (off_t)phys;
+    }
+
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, lp->fd, off);
+    if (map == MAP_FAILED) {
+        xil_printf("[ERROR] Cannot map DMA memory at 0x%08lx\r\n", phys);
+        return 0;
+    }
+    lx_dma_map  = (u32 *)map;
+    lx_dma_phys = (u32)phys;
+    lx_dma_size = (u32)size;
+    return 1;
+}
+
+static void *lx_dma_alloc(mont_dev_t *dev, u32 bytes, u32 *phys)
+{
+    u32 *p;
+
+    if (!lx_dma_map_pool(dev) || bytes > lx_dma_size - lx_dma_used)
+        return NULL;
+    p = lx_dma_map + lx_dma_used / 4U;
+    *phys = lx_dma_phys + lx_dma_used;
+    lx_dma_used += bytes;
+    return p;
+}
+
+static void lx_dma_sync(mont_dev_t *dev, void *buf, u32 bytes, int to_dev)
+{
+    (void)dev;
+    (void)buf;
+    (void)bytes;
+    (void)to_dev;
+    __sync_synchronize();
+}
+
+static const mont_hal_ops_t lx_ops = {
+    lx_write_block,
+    lx_read_block,
+    lx_write_reg,
+    lx_read_reg,
+    mont_hal_poll_done,
+    lx_close,
+    NULL,
+    lx_irq_enable,
+    lx_irq_wait,
+    lx_dma_alloc,
+    lx_dma_sync
+};
+
+/* UIO devices are numbered in probe order, so match on the map address */
+#define LX_MAX_UIO  16
+
+int mont_hal_uio_find(uintptr_t phys, char *path, u32 len)
+{
+    for (u32 n = 0; n < LX_MAX_UIO; ++n) {
+        char  name[64];
+        char  line[32];
+        FILE *f;
+
+        snprintf(name, sizeof(name), "/sys/class/uio/uio%u/maps/map0/addr", (unsigned)n);
+        f = fopen(name, "r");
+        if (f == NULL)
+            continue;
+        if (fgets(line, sizeof(line), f) != NULL &&
+            (uintptr_t)strtoul(line, NULL, 0) == phys) {
+            fclose(f);
+            snprintf(path, len, "/dev/uio%u", (unsigned)n);
+            return 1;
+        }
+        fclose(f);
+    }
+    return 0;
+}
+
+/* one slot per IP block on the board is plenty */
+#define LX_MAX_DEVS 4
+static linux_priv_t lx_priv[LX_MAX_DEVS];
+
+int mont_hal_linux_open(mont_dev_t *dev, const char *path, uintptr_t phys, u32 nwords)
+{
+    int is_uio = (strncmp(path, "/dev/uio", 8) == 0);
+    off_t map_off = is_uio ? 0 : (off_t)phys;
+    linux_priv_t *lp;
+    void *map;
+    int fd;
+    u32 i;
+
+    for (i = 0; i < LX_MAX_DEVS && lx_priv[i].in_use; ++i)
+        ;
+    if (i == LX_MAX_DEVS) {
+        xil_printf("[ERROR] Too many open Montgomery devices\r\n");
+        return 0;
+    }
+
+    fd = open(path, O_RDWR | O_SYNC);
+    if (fd < 0) {
+        xil_printf("[ERROR] Cannot open %s\r\n", path);
+        return 0;
+    }
+
+    map = mmap(NULL, MONT_REG_SPAN, PROT_READ | PROT_WRITE, MAP_SHARED, fd, map_off);
+    if (map == MAP_FAILED) {
+        xil_printf("[ERROR] mmap of %s (offset 0x%08lx) failed\r\n",
+                   path, (unsigned long)map_off);
+        close(fd);
+        return 0;
+    }
+
+    lp = &lx_priv[i];
+    lp->in_use = 1;
+    lp->fd     = fd;
+    lp->is_uio = is_uio;
+    lp->map    = map;
+    snprintf(lp->path, sizeof(lp->path), "%s", path);
+
+    dev->ops     = &lx_ops;
+    dev->backend = is_uio ? "uio" : "devmem";
+    dev->nwords  = nwords;
+    dev->base    = phys;
+    dev->regs    = (volatile u32 *)map;
+    dev->priv    = lp;
+    return 1;
+}
+
+#endif /* MONT_HAL_LINUX */
@@ -0,0 +1,424 @@
+/* -------------------------------------------------------------------------- */
+/* mont_hal_model.c                                                           */
+/* Software model of montgomery_axi: same register map, result computed      */
+/* with montgomery_mul_sw when CONTROL.start is written (CONTROL.modexp runs  */
+/* the same square-and-multiply sequence as the RTL sequencer). Both operand */
+/* banks, all key slots and the X0 / X1 / previous-result operand sources    */
+/* are modelled; jobs finish at once, so nothing is ever queued and the one   */
+/* lane (HWCFG) is never busy in LANE_STATUS. CONTROL.dma jobs read their     */
+/* descriptor from a static pool standing in for DDR, and a RING_TAIL write   */
+/* runs every posted ring descriptor before it returns.                       */
+/*                                                                            */
+/* Lets modexp/benchmark code run on any host; timings then measure only the  */
+/* driver-side overhead plus the software kernel.                             */
+/* -------------------------------------------------------------------------- */
+#include "mont_hal.h"
+
+/* one operand bank (CONTROL.bank) */
+typedef struct {
+    u32 a_mem[MAX_WORDS];
+    u32 b_mem[MAX_WORDS];
+    u32 y_mem[MAX_WORDS];
+    u32 e_mem[MAX_WORDS];
+    u32 exp_bits_reg;
+    u32 done_reg;
+} model_bank_t;
+
+/* one key slot (CONTROL.slot) */
+typedef struct {
+    u32 n_mem[MAX_WORDS];
+    u32 r2_mem[MAX_WORDS];
+    u32 n_prime_reg;
+    u32 bits_reg;
+    u32 len_reg;                        /* KEY_LEN: operand length in bits */
+} model_key_t;
+
+typedef struct {
+    model_bank_t bank[2];
+    model_key_t  key[MONT_NUM_KEYS];
+    u32          x0[MAX_WORDS];          /* sequencer x / a registers */
+    u32          x1[MAX_WORDS];
+    u32          last[MAX_WORDS];        /* core result register */
+    u32          host_bank;
+    u32          host_slot;
+    u32          dma_desc;
+    u32          dma_err;
+    u32          ring_base;
+    u32          ring_size;
+    u32          ring_tail;
+    u32          ring_head;
+    u32          ring_bank;              /* bank of the next ring job */
+    u32          irq_stat;
+    u32          in_use;                 /* slot taken, cleared by close */
+} model_priv_t;
+
+#define MODEL_MAX_DEVS 4
+static model_priv_t model_priv[MODEL_MAX_DEVS];
+
+/* "DDR" for CONTROL.dma, shared by all model devices */
+#define MODEL_DMA_PHYS  0x1FF00000U
+#define MODEL_DMA_WORDS (64U * 1024U)
+static u32          model_dma_pool[MODEL_DMA_WORDS];
+static u32          model_dma_used;     /* words */
+
+/* pool words [phys, phys + 4*nwords), NULL (bus error) outside the pool */
+static u32 *model_dma_ptr(u32 phys, u32 nwords)
+{
+    if (phys < MODEL_DMA_PHYS || (phys & 3U) != 0U ||
+        (phys - MODEL_DMA_PHYS) / 4U + nwords > MODEL_DMA_WORDS)
+        return NULL;
+    return &model_dma_pool[(phys - MODEL_DMA_PHYS) / 4U];
+}
+
+/* word index into one of the 0x200-byte operand windows, or -1 */
+static int model_word(mont_dev_t *dev, u32 off, u32 window)
+{
+    if (off >= window && off < window + 4U * dev->nwords)
+        return (int)((off - window) / 4U);
+    return -1;
+}
+
+/* KEY_LEN write: multiples of 512 below the core width on a varlen core,
+ * the full width for 0, anything longer or a fixed-width core */
+static u32 model_key_len(mont_dev_t *dev, u32 val)
+{
+    u32 width = 32U * dev->nwords;
+
+    if ((width % 512U) != 0U || val == 0U || val > width)
+        return width;
+    return (val + 511U) & ~511U;
+}
+
+/* CONTROL.modexp: same product sequence as the montgomery_axi sequencer,
+ * which leaves x and a behind in X0 / X1 */
+static void model_modexp(mont_dev_t *dev, model_priv_t *pv, model_bank_t *mp,
+                         const model_key_t *k)
+{
+    u32 nw = k->len_reg / 32U;
+    u32 one[MAX_WORDS];
+    u32 *x = pv->x0, *a = pv->x1;
+
+    /* the core masks everything above KEY_LEN */
+    bigint_set_u32(x, 0U, dev->nwords);
+    bigint_set_u32(a, 0U, dev->nwords);
+    bigint_set_u32(pv->last, 0U, dev->nwords);
+    bigint_set_u32(one, 1U, nw);
+    montgomery_mul_sw(nw, one, k->r2_mem, k->n_mem, k->n_prime_reg, x);
+    montgomery_mul_sw(nw, mp->a_mem, k->r2_mem, k->n_mem, k->n_prime_reg, a);
+
+    for (u32 i = 0; i < mp->exp_bits_reg; ++i) {
+        if ((mp->e_mem[i / 32U] >> (i % 32U)) & 1U)
+            montgomery_mul_sw(nw, x, a, k->n_mem, k->n_prime_reg, x);
+        if (i + 1U < mp->exp_bits_reg)
+            montgomery_mul_sw(nw, a, a, k->n_mem, k->n_prime_reg, a);
+    }
+
+    montgomery_mul_sw(nw, x, one, k->n_mem, k->n_prime_reg, pv->last);
+    bigint_copy(mp->y_mem, pv->last, dev->nwords);
+}
+
+/* CONTROL.asrc / bsrc operand */
+static const u32 *model_src(model_priv_t *pv, const model_key_t *k,
+                            const u32 *mem, const u32 *one, u32 src)
+{
+    switch (src) {
+    case MONT_SRC_RES: return pv->last;
+    case MONT_SRC_X0:  return pv->x0;
+    case MONT_SRC_X1:  return pv->x1;
+    case MONT_SRC_ONE: return one;
+    case MONT_SRC_R2:  return k->r2_mem;
+    default:           return mem;
+    }
+}
+
+/* single product with forwarded operands and an optional X0 / X1 copy */
+static void model_plain(mont_dev_t *dev, model_priv_t *pv, model_bank_t *mp,
+                        const model_key_t *k, u32 ctl)
+{
+    u32 nw = k->len_reg / 32U;
+    u32 one[MAX_WORDS], y[MAX_WORDS];
+    u32 dst = (ctl >> 16) & 0x3U;
+
+    bigint_set_u32(one, 1U, nw);
+    bigint_set_u32(y, 0U, dev->nwords);
+    montgomery_mul_sw(nw, model_src(pv, k, mp->a_mem, one, (ctl >> 8) & 0x7U),
+                      model_src(pv, k, mp->b_mem, one, (ctl >> 12) & 0x7U),
+                      k->n_mem, k->n_prime_reg, y);
+    bigint_copy(pv->last, y, dev->nwords);
+    bigint_copy(mp->y_mem, y, dev->nwords);
+    if (dst == MONT_DST_X0)
+        bigint_copy(pv->x0, y, dev->nwords);
+    else if (dst == MONT_DST_X1)
+        bigint_copy(pv->x1, y, dev->nwords);
+}
+
+/* Descriptor d: operands in, result back out, KEY_LEN/32 words each; a bad
+ * address ends the job (without running it, if it is an operand). B is the
+ * exponent for modexp. */
+static int model_dma_in(const u32 *d, model_bank_t *mp, model_key_t *k,
+                        u32 ctl)
+{
+    u32 nw = k->len_reg / 32U;
+    const u32 *p;
+
+    if (d[1] != 0U) {
+        if ((p = model_dma_ptr(d[1], nw)) == NULL)
+            return 0;
+        bigint_copy(mp->a_mem, p, nw);
+    }
+    if (d[2] != 0U) {
+        if ((p = model_dma_ptr(d[2], nw)) == NULL)
+            return 0;
+        bigint_copy((ctl & CONTROL_MODEXP) ? mp->e_mem : mp->b_mem, p, nw);
+    }
+    if (d[3] != 0U) {
+        if ((p = model_dma_ptr(d[3], nw)) == NULL)
+            return 0;
+        bigint_copy(k->n_mem, p, nw);
+        k->n_prime_reg = d[5];
+    }
+    return 1;
+}
+
+static int model_dma_out(const u32 *d, model_bank_t *mp, const model_key_t *k)
+{
+    u32 nw = k->len_reg / 32U;
+    u32 *p;
+
+    if (d[4] == 0U)
+        return 1;
+    if ((p = model_dma_ptr(d[4], nw)) == NULL)
+        return 0;
+    bigint_copy(p, mp->y_mem, nw);
+    return 1;
+}
+
+/* one job; d is its descriptor (NULL: operands already on chip). Returns 0
+ * on a bus error. */
+static int model_job(mont_dev_t *dev, model_priv_t *pv, model_bank_t *mp,
+                     model_key_t *k, u32 ctl, const u32 *d)
+{
+    if (d != NULL && !model_dma_in(d, mp, k, ctl))
+        return 0;
+    /* the core works on the slot's KEY_LEN bits */
+    if (ctl & CONTROL_MODEXP)
+        model_modexp(dev, pv, mp, k);
+    else
+        model_plain(dev, pv, mp, k, ctl);
+    return d == NULL || model_dma_out(d, mp, k);
+}
+
+/* RING_TAIL: run every posted descriptor, in order, on alternating banks */
+static void model_ring(mont_dev_t *dev, model_priv_t *pv)
+{
+    while (pv->ring_size != 0U && pv->ring_head != pv->ring_tail) {
+        u32 *d = model_dma_ptr(pv->ring_base + 32U * pv->ring_head, 8U);
+
+        if (d != NULL) {
+            model_bank_t *mp = &pv->bank[pv->ring_bank];
+            model_key_t  *k  = &pv->key[((d[0] >> 4) & 0xFU) % MONT_NUM_KEYS];
+
+            mp->exp_bits_reg = (d[6] > 32U * dev->nwords) ? 32U * dev->nwords : d[6];
+            d[7] = model_job(dev, pv, mp, k, d[0], d) ? RING_DONE
+                                                      : (RING_DONE | RING_ERR);
+            pv->ring_bank ^= 1U;
+        }
+        pv->ring_head = (pv->ring_head + 1U == pv->ring_size) ? 0U : pv->ring_head + 1U;
+        pv->irq_stat |= IRQ_RING;
+    }
+}
+
+static void model_write_reg(mont_dev_t *dev, u32 off, u32 val)
+{
+    model_priv_t *pv = (model_priv_t *)dev->priv;
+    model_bank_t *mp = &pv->bank[pv->host_bank];
+    model_key_t  *k  = &pv->key[pv->host_slot];
+    int w;
+
+    if ((w = model_word(dev, off, REG_A(0))) >= 0) {
+        mp->a_mem[w] = val;
+    } else if ((w = model_word(dev, off, REG_B(0))) >= 0) {
+        mp->b_mem[w] = val;
+    } else if ((w = model_word(dev, off, REG_N(0))) >= 0) {
+        k->n_mem[w] = val;
+    } else if ((w = model_word(dev, off, REG_R2(0))) >= 0) {
+        k->r2_mem[w] = val;
+    } else if ((w = model_word(dev, off, REG_EXP(0))) >= 0) {
+        mp->e_mem[w] = val;
+    } else if (off == REG_NPRIME) {
+        k->n_prime_reg = val;
+    } else if (off == REG_KEY_BITS) {
+        k->bits_reg = val;
+    } else if (off == REG_KEY_LEN) {
+        k->len_reg = model_key_len(dev, val);
+    } else if (off == REG_EXP_BITS) {
+        mp->exp_bits_reg = (val > 32U * dev->nwords) ? 32U * dev->nwords : val;
+    } else if (off == REG_DMA_DESC) {
+        pv->dma_desc = val;
+    } else if (off == REG_RING_BASE) {
+        pv->ring_base = val;
+    } else if (off == REG_RING_SIZE) {
+        pv->ring_size = val & 0xFFFFU;
+        pv->ring_tail = 0U;
+        pv->ring_head = 0U;
+    } else if (off == REG_RING_TAIL) {
+        pv->ring_tail = val & 0xFFFFU;
+        model_ring(dev, pv);
+    } else if (off == REG_IRQ_STATUS) {
+        pv->irq_stat &= ~val;
+    } else if (off == REG_CONTROL) {
+        pv->host_bank = (val & CONTROL_BANK1) ? 1U : 0U;
+        pv->host_slot = ((val >> 4) & 0xFU) % MONT_NUM_KEYS;
+        mp = &pv->bank[pv->host_bank];
+        k  = &pv->key[pv->host_slot];
+        if (val & CONTROL_START) {
+            const u32 *d = NULL;
+
+            pv->dma_err = 0U;
+            if ((val & CONTROL_DMA) &&
+                (d = model_dma_ptr(pv->dma_desc, 8U)) == NULL)
+                pv->dma_err = 1U;
+            else if (!model_job(dev, pv, mp, k, val, d))
+                pv->dma_err = 1U;
+            mp->done_reg  = 1U;
+            pv->irq_stat |= IRQ_DONE;
+        }
+    }
+    /* STATUS and result are read-only */
+}
+
+static u32 model_read_reg(mont_dev_t *dev, u32 off)
+{
+    model_priv_t *pv = (model_priv_t *)dev->priv;
+    model_bank_t *mp = &pv->bank[pv->host_bank];
+    model_key_t  *k  = &pv->key[pv->host_slot];
+    int w;
+
+    if ((w = model_word(dev, off, REG_RES(0))) >= 0) return mp->y_mem[w];
+    if ((w = model_word(dev, off, REG_EXP(0))) >= 0) return mp->e_mem[w];
+    if (off == REG_NPRIME)                           return k->n_prime_reg;
+    if (off == REG_KEY_BITS)                         return k->bits_reg;
+    if (off == REG_KEY_LEN)                          return k->len_reg;
+    if (off == REG_EXP_BITS)                         return mp->exp_bits_reg;
+    if (off == REG_CONTROL)                          return CONTROL_BANK(pv->host_bank) |
+                                                            CONTROL_SLOT(pv->host_slot);
+    if (off == REG_STATUS)                           return mp->done_reg |
+                                                            (pv->dma_err ? STATUS_DMA_ERR : 0U);
+    if (off == REG_DMA_DESC)                         return pv->dma_desc;
+    if (off == REG_RING_BASE)                        return pv->ring_base;
+    if (off == REG_RING_SIZE)                        return pv->ring_size;
+    if (off == REG_RING_TAIL)                        return pv->ring_tail;
+    if (off == REG_RING_HEAD)                        return pv->ring_head;
+    if (off == REG_IRQ_STATUS)                       return pv->irq_stat;
+    if (off == REG_HWCFG)                            return (32U * dev->nwords) |
+                                                            ((MONT_NUM_KEYS - 1U) << 20) |
+                                                            HWCFG_DMA |
+                                                            ((dev->nwords % 16U == 0U) ?
+                                                             HWCFG_VARLEN : 0U);
+    return 0U;    /* A, B, N and R^2 are write-only */
+}
+
+static void model_write_block(mont_dev_t *dev, u32 off, const u32 *src, u32 nwords)
+{
+    for (u32 i = 0; i < nwords; ++i)
+        model_write_reg(dev, off + 4U*i, src[i]);
+}
+
+static void model_read_block(mont_dev_t *dev, u32 off, u32 *dst, u32 nwords)
+{
+    for (u32 i = 0; i < nwords; ++i)
+        dst[i] = model_read_reg(dev, off + 4U*i);
+}
+
+static void *model_dma_alloc(mont_dev_t *dev, u32 bytes, u32 *phys)
+{
+    u32 *p;
+
+    (void)dev;
+    if (bytes / 4U > MODEL_DMA_WORDS - model_dma_used)
+        return NULL;
+    p = &model_dma_pool[model_dma_used];
+    *phys = MODEL_DMA_PHYS + 4U * model_dma_used;
+    model_dma_used += bytes / 4U;
+    return p;
+}
+
+static void model_close(mont_dev_t *dev)
+{
+    ((model_priv_t *)dev->priv)->in_use = 0U;
+}
+
+static const mont_hal_ops_t model_ops = {
+    model_write_block,
+    model_read_block,
+    model_write_reg,
+    model_read_reg,
+    mont_hal_poll_done,
+    model_close,
+    NULL,
+    NULL,
+    NULL,
+    model_dma_alloc,
+    NULL
+};
+
+int mont_hal_model_open(mont_dev_t *dev, u32 nwords)
+{
+    model_priv_t *mp;
+    u32 d;
+
+    for (d = 0; d < MODEL_MAX_DEVS && model_priv[d].in_use; ++d)
+        ;
+    if (d == MODEL_MAX_DEVS || nwords > MAX_WORDS) {
+        xil_printf("[ERROR] Cannot create Montgomery model (%u words)\r\n",
+                   (unsigned)nwords);
+        return 0;
+    }
+
+    mp = &model_priv[d];
+    mp->in_use = 1U;
+    for (u32 b = 0; b < 2U; ++b) {
+        model_bank_t *mb = &mp->bank[b];
+        for (u32 i = 0; i < MAX_WORDS; ++i) {
+            mb->a_mem[i] = 0U;
+            mb->b_mem[i] = 0U;
+            mb->y_mem[i] = 0U;
+            mb->e_mem[i] = 0U;
+        }
+        mb->exp_bits_reg = 0U;
+        mb->done_reg     = 0U;
+    }
+    for (u32 s = 0; s < MONT_NUM_KEYS; ++s) {
+        model_key_t *k = &mp->key[s];
+        for (u32 i = 0; i < MAX_WORDS; ++i) {
+            k->n_mem[i]  = 0U;
+            k->r2_mem[i] = 0U;
+        }
+        k->n_prime_reg = 0U;
+        k->bits_reg    = 0U;
+        k->len_reg     = 32U * nwords;
+    }
+    for (u32 i = 0; i < MAX_WORDS; ++i) {
+        mp->x0[i]   = 0U;
+        mp->x1[i]   = 0U;
+        mp->last[i] = 0U;
+    }
+    mp->host_bank = 0U;
+    mp->host_slot = 0U;
+    mp->dma_desc  = 0U;
+    mp->dma_err   = 0U;
+    mp->ring_base = 0U;
+    mp->ring_size = 0U;
+    mp->ring_tail = 0U;
+    mp->ring_head = 0U;
+    mp->ring_bank = 1U;
+    mp->irq_stat  = 0U;
+
+    dev->ops     = &model_ops;
+    dev->backend = "model";
+    dev->nwords  = nwords;
+    dev->base    = 0U;
+    dev->regs    = NULL;
+    dev->priv    = mp;
+    return 1;
+}
@@ -0,0 +1,374 @@
+/* -------------------------------------------------------------------------- */
+/* mont_sw.c                                                                  */
+/* Big-integer helpers, word-serial (CIOS) Montgomery multiplication,         */
+/* Montgomery contexts and the sliding-window exponentiation engine           */
+/* -------------------------------------------------------------------------- */
+#include <stddef.h>
+
+#include "mont_sw.h"
+
+/* -------------------------------------------------------------------------- */
+/* Big-integer helpers                                                        */
+/* -------------------------------------------------------------------------- */
+
+void bigint_copy(u32 *dst, const u32 *src, u32 nwords)
+{
+    for (u32 i = 0; i < nwords; ++i)
+        dst[i] = src[i];
+}
+
+void bigint_set_u32(u32 *dst, u32 v, u32 nwords)
+{
+    dst[0] = v;
+    for (u32 i = 1; i < nwords; ++i)
+        dst[i] = 0U;
+}
+
+int bigint_equal(const u32 *a, const u32 *b, u32 nwords)
+{
+    for (u32 i = 0; i < nwords; ++i)
+        if (a[i] != b[i])
+            return 0;
+    return 1;
+}
+
+u32 bigint_bits(const u32 *a, u32 nwords)
+{
+    for (u32 i = nwords; i-- > 0; ) {
+        if (a[i] != 0U) {
+            u32 bits = 32U * i;
+            for (u32 w = a[i]; w != 0U; w >>= 1)
+                ++bits;
+            return bits;
+        }
+    }
+    return 0U;
+}
+
+u32 bigint_add(u32 *r, const u32 *a, const u32 *b, u32 nwords)
+{
+    u64 carry = 0ULL;
+
+    for (u32 i = 0; i < nwords; ++i) {
+        carry += (u64)a[i] + (u64)b[i];
+        r[i]   = (u32)carry;
+        carry >>= 32;
+    }
+    return (u32)carry;
+}
+
+u32 bigint_sub(u32 *r, const u32 *a, const u32 *b, u32 nwords)
+{
+    u64 borrow = 0ULL;
+
+    for (u32 i = 0; i < nwords; ++i) {
+        u64 d = (u64)a[i] - (u64)b[i] - borrow;
+        r[i]   = (u32)d;
+        borrow = (d >> 63) & 1ULL;
+    }
+    return (u32)borrow;
+}
+
+/* schoolbook product */
+void bigint_mul(u32 *r, const u32 *a, u32 awords, const u32 *b, u32 bwords)
+{
+    for (u32 i = 0; i < awords + bwords; ++i)
+        r[i] = 0U;
+
+    for (u32 i = 0; i < bwords; ++i) {
+        u64 carry = 0ULL;
+        for (u32 j = 0; j < awords; ++j) {
+            carry += (u64)r[i + j] + (u64)a[j] * (u64)b[i];
+            r[i + j] = (u32)carry;
+            carry >>= 32;
+        }
+        r[i + awords] = (u32)carry;
+    }
+}
+
+/* binary long division, one bit of a per step: fine for the few
+ * reductions per private-key operation, not for inner loops */
+void bigint_mod(u32 *r, const u32 *a, u32 awords, const u32 *m, u32 mwords)
+{
+    u32 t[MAX_WORDS + 1];
+    u32 mx[MAX_WORDS + 1];
+
+    bigint_set_u32(t, 0U, mwords + 1U);
+    bigint_copy(mx, m, mwords);
+    mx[mwords] = 0U;
+
+    for (u32 i = 32U * awords; i-- > 0; ) {
+        u32 in = (a[i / 32U] >> (i % 32U)) & 1U;
+
+        /* t = 2t + bit; t < 2m fits in mwords + 1 words */
+        for (u32 j = 0; j <= mwords; ++j) {
+            u32 out = t[j] >> 31;
+            t[j] = (t[j] << 1) | in;
+            in = out;
+        }
+
+        /* t -= m if t >= m */
+        {
+            u32 d[MAX_WORDS + 1];
+            if (!bigint_sub(d, t, mx, mwords + 1U))
+                bigint_copy(t, d, mwords + 1U);
+        }
+    }
+    bigint_copy(r, t, mwords);
+}
+
+void mont_exp_set_u32(mont_exp_t *e, u32 v)
+{
+    bigint_set_u32(e->w, v, MAX_WORDS);
+    e->bits = bigint_bits(e->w, 1U);
+}
+
+u32 mont_exp_bit(const mont_exp_t *e, u32 i)
+{
+    return (e->w[i / 32U] >> (i % 32U)) & 1U;
+}
+
+/* software Montgomery multiply (word-serial CIOS): R = A * B * R^{-1} mod N
+ *
+ * Same contract as the HW core: A, B < N, N odd, R = 2^(32*nwords).
+ * nprime = -N^{-1} mod 2^32. R may alias A or B. */
+void montgomery_mul_sw(u32 nwords,
+                       const u32 *A,
+                       const u32 *B,
+                       const u32 *N,
+                       u32 nprime,
+                       u32 *R)
+{
+    u32 t[MAX_WORDS + 2];
+    u32 i, j;
+
+    for (i = 0; i < nwords + 2U; ++i)
+        t[i] = 0U;
+
+    for (i = 0; i < nwords; ++i) {
+        u64 carry = 0ULL;
+        u64 s;
+        u32 m;
+
+        /* t += A * B[i] */
+        for (j = 0; j < nwords; ++j) {
+            s = (u64)t[j] + (u64)A[j] * (u64)B[i] + carry;
+            t[j]  = (u32)s;
+            carry = s >> 32;
+        }
+        s = (u64)t[nwords] + carry;
+        t[nwords]     = (u32)s;
+        t[nwords + 1] = (u32)(s >> 32);
+
+        /* t = (t + m * N) / 2^32, with m chosen so the low word cancels */
+        m = t[0] * nprime;
+        s = (u64)t[0] + (u64)m * (u64)N[0];
+        carry = s >> 32;
+        for (j = 1; j < nwords; ++j) {
+            s = (u64)t[j] + (u64)m * (u64)N[j] + carry;
+            t[j - 1] = (u32)s;
+            carry    = s >> 32;
+        }
+        s = (u64)t[nwords] + carry;
+        t[nwords - 1] = (u32)s;
+        t[nwords]     = t[nwords + 1] + (u32)(s >> 32);
+    }
+
+    /* t < 2N here, so one conditional subtract is enough */
+    {
+        int ge = (t[nwords] != 0U);
+
+        if (!ge) {
+            ge = 1;     /* equal counts as >= */
+            for (i = nwords; i > 0; ) {
+                --i;
+                if (t[i] > N[i]) { ge = 1; break; }
+                if (t[i] < N[i]) { ge = 0; break; }
+            }
+        }
+
+        if (ge) {
+            u64 borrow = 0ULL;
+            for (i = 0; i < nwords; ++i) {
+                u64 d = (u64)t[i] - (u64)N[i] - borrow;
+                t[i]   = (u32)d;
+                borrow = (d >> 63) & 1ULL;
+            }
+        }
+    }
+
+    for (i = 0; i < nwords; ++i)
+        R[i] = t[i];
+}
+
+/* -------------------------------------------------------------------------- */
+/* Montgomery context                                                         */
+/* -------------------------------------------------------------------------- */
+
+/* r = 2r mod N (r < N) */
+static void mod_double(u32 *r, const u32 *N, u32 nwords)
+{
+    u32 d[MAX_WORDS];
+    u32 top = r[nwords - 1U] >> 31;
+
+    for (u32 i = nwords; i-- > 1U; )
+        r[i] = (r[i] << 1) | (r[i - 1U] >> 31);
+    r[0] <<= 1;
+
+    /* 2r < 2N: one subtract, needed on a carry out or if 2r >= N */
+    if (bigint_sub(d, r, N, nwords) <= top)
+        bigint_copy(r, d, nwords);
+}
+
+/* odd, > 1 and at most MAX_WORDS words */
+static int mont_ctx_valid(const u32 *N, u32 nwords)
+{
+    return nwords != 0U && nwords <= MAX_WORDS && (N[0] & 1U) != 0U &&
+           bigint_bits(N, nwords) >= 2U;
+}
+
+int mont_ctx_init(mont_ctx_t *ctx, const u32 *N, u32 nwords)
+{
+    u32 inv;
+
+    if (!mont_ctx_valid(N, nwords))
+        return 0;
+
+    ctx->nwords = nwords;
+    ctx->bits   = bigint_bits(N, nwords);
+    bigint_copy(ctx->n, N, nwords);
+
+    /* Newton: each step doubles the correct low bits of N^{-1} mod 2^32;
+     * inv = N starts with 3 (N * N = 1 mod 8) */
+    inv = N[0];
+    for (u32 i = 0; i < 4U; ++i)
+        inv *= 2U - N[0] * inv;
+    ctx->nprime = 0U - inv;
+
+    /* R mod N and R^2 mod N = R * 2^(32*nwords) mod N by doubling */
+    bigint_set_u32(ctx->r1, 1U, nwords);
+    for (u32 i = 0; i < 32U * nwords; ++i)
+        mod_double(ctx->r1, N, nwords);
+    bigint_copy(ctx->r2, ctx->r1, nwords);
+    for (u32 i = 0; i < 32U * nwords; ++i)
+        mod_double(ctx->r2, N, nwords);
+
+    return 1;
+}
+
+static mont_ctx_t ctx_cache[MONT_CTX_CACHE];
+static u32        ctx_used[MONT_CTX_CACHE];     /* 0: free, else LRU tick */
+static u32        ctx_tick;
+
+const mont_ctx_t *mont_ctx_get(const u32 *N, u32 nwords)
+{
+    u32 victim = 0U;
+
+    /* an invalid N must not evict anything */
+    if (!mont_ctx_valid(N, nwords))
+        return NULL;
+
+    ++ctx_tick;
+    for (u32 i = 0; i < MONT_CTX_CACHE; ++i) {
+        if (ctx_used[i] != 0U && ctx_cache[i].nwords == nwords &&
+            bigint_equal(ctx_cache[i].n, N, nwords)) {
+            ctx_used[i] = ctx_tick;
+            return &ctx_cache[i];
+        }
+        if (ctx_used[i] < ctx_used[victim])
+            victim = i;
+    }
+
+    (void)mont_ctx_init(&ctx_cache[victim], N, nwords);
+    ctx_used[victim] = ctx_tick;
+    return &ctx_cache[victim];
+}
+
+/* -------------------------------------------------------------------------- */
+/* Sliding-window exponentiation                                              */
+/* -------------------------------------------------------------------------- */
+
+/* width w minimising about exp_bits/(w+1) multiplies + 2^(w-1) table entries */
+u32 modexp_window_bits(u32 exp_bits)
+{
+    u32 w = (exp_bits > 239U) ? 5U :
+            (exp_bits >  79U) ? 4U :
+            (exp_bits >  23U) ? 3U : 1U;
+
+    return (w > MODEXP_WIN_MAX) ? MODEXP_WIN_MAX : w;
+}
+
+/* tab[k] = (base * R)^(2k+1) mod N in the Montgomery domain */
+static u32 win_tab[1U << (MODEXP_WIN_MAX - 1U)][MAX_WORDS];
+
+/* Left-to-right sliding window (HAC 14.85): every zero bit costs a squaring,
+ * every window of up to w bits that starts and ends with a one costs its
+ * squarings and one multiply by a table entry. Compared with right-to-left
+ * binary this leaves about exp_bits/(w+1) multiplies instead of
+ * popcount(E); the leading squarings of 1 are skipped. */
+int modexp_window(mont_mul_fn mul,
+                  void *ctx,
+                  u32 nwords,
+                  const u32 *base,
+                  const mont_exp_t *exp,
+                  const u32 *R2,
+                  u32 *result)
+{
+    u32 one[MAX_WORDS];
+    u32 x[MAX_WORDS];
+    u32 exp_bits = exp->bits;
+    u32 w = modexp_window_bits(exp_bits);
+    u32 k;
+    int started = 0;
+    int i;
+
+    while (exp_bits > 0U && !mont_exp_bit(exp, exp_bits - 1U))
+        --exp_bits;
+    if (exp_bits == 0U) {
+        bigint_set_u32(result, 1U, nwords);
+        return 1;
+    }
+
+    bigint_set_u32(one, 1U, nwords);
+
+    /* odd powers a, a^3, ... a^(2^w - 1); x holds a^2 meanwhile */
+    if (!mul(ctx, base, R2, win_tab[0])) return 0;
+    if (w > 1U) {
+        if (!mul(ctx, win_tab[0], win_tab[0], x)) return 0;
+        for (k = 1U; k < (1U << (w - 1U)); ++k)
+            if (!mul(ctx, win_tab[k - 1U], x, win_tab[k])) return 0;
+    }
+
+    for (i = (int)exp_bits - 1; i >= 0; ) {
+        u32 val = 0U;
+        int j;
+        int b;
+
+        if (!mont_exp_bit(exp, (u32)i)) {
+            if (started && !mul(ctx, x, x, x)) return 0;
+            --i;
+            continue;
+        }
+
+        /* longest window i .. j (at most w bits) that ends in a one */
+        j = i - (int)w + 1;
+        if (j < 0)
+            j = 0;
+        while (!mont_exp_bit(exp, (u32)j))
+            ++j;
+        for (b = i; b >= j; --b)
+            val = (val << 1) | mont_exp_bit(exp, (u32)b);
+
+        if (started) {
+            for (b = i; b >= j; --b)
+                if (!mul(ctx, x, x, x)) return 0;
+            if (!mul(ctx, x, win_tab[val >> 1], x)) return 0;
+        } else {
+            bigint_copy(x, win_tab[val >> 1], nwords);
+            started = 1;
+        }
+        i = j - 1;
+    }
+
+    return mul(ctx, x, one, result);        /* leave the Montgomery domain */
+}
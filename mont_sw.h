@@ -0,0 +1,102 @@
+/* -------------------------------------------------------------------------- */
+/* mont_sw.h                                                                  */
+/* Big-integer helpers and the software Montgomery kernel                    */
+/*                                                                            */
+/* Numbers are little-endian arrays of 32-bit words (word 0 = LSW).           */
+/* -------------------------------------------------------------------------- */
+#ifndef MONT_SW_H
+#define MONT_SW_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+/* word sizes */
+#define NWORDS_1024     32U        /* 1024 / 32 */
+#define NWORDS_2048     64U        /* 2048 / 32 */
+#define NWORDS_4096     128U       /* 4096 / 32 */
+#define MAX_WORDS       NWORDS_4096
+
+void bigint_copy(u32 *dst, const u32 *src, u32 nwords);
+void bigint_set_u32(u32 *dst, u32 v, u32 nwords);
+int  bigint_equal(const u32 *a, const u32 *b, u32 nwords);
+u32  bigint_bits(const u32 *a, u32 nwords);     /* index of top set bit + 1 */
+u32  bigint_add(u32 *r, const u32 *a, const u32 *b, u32 nwords); /* carry  */
+u32  bigint_sub(u32 *r, const u32 *a, const u32 *b, u32 nwords); /* borrow */
+
+/* r = a * b, awords + bwords words; r must not alias a or b */
+void bigint_mul(u32 *r, const u32 *a, u32 awords, const u32 *b, u32 bwords);
+
+/* r = a mod m (m != 0, mwords <= MAX_WORDS, r may alias a) */
+void bigint_mod(u32 *r, const u32 *a, u32 awords, const u32 *m, u32 mwords);
+
+/* R = A * B * 2^(-32*nwords) mod N  (A, B < N, N odd, R may alias A/B) */
+void montgomery_mul_sw(u32 nwords,
+                       const u32 *A,
+                       const u32 *B,
+                       const u32 *N,
+                       u32 nprime,
+                       u32 *R);
+
+/* Montgomery parameters of one modulus, R = 2^(32*nwords) */
+typedef struct {
+    u32 nwords;
+    u32 bits;                   /* bits(N) */
+    u32 n[MAX_WORDS];
+    u32 nprime;                 /* -N^{-1} mod 2^32 */
+    u32 r1[MAX_WORDS];          /* R mod N, the Montgomery form of 1 */
+    u32 r2[MAX_WORDS];          /* R^2 mod N */
+} mont_ctx_t;
+
+/* entries of the mont_ctx_get() cache */
+#define MONT_CTX_CACHE  8U
+
+/* Compute ctx for N (nwords words, odd, > 1). Returns 0 for an invalid N. */
+int mont_ctx_init(mont_ctx_t *ctx, const u32 *N, u32 nwords);
+
+/* Context of N from a small LRU cache, computed on a miss only: call it at
+ * key load and keep the pointer. It stays valid until MONT_CTX_CACHE other
+ * moduli have been looked up. NULL for an invalid N. Not reentrant. */
+const mont_ctx_t *mont_ctx_get(const u32 *N, u32 nwords);
+
+/* Exponent of up to 32*MAX_WORDS bits: w[] LS word first, bits its length
+ * (square-and-multiply runs one step per bit, leading zeros included). */
+typedef struct {
+    u32 w[MAX_WORDS];
+    u32 bits;
+} mont_exp_t;
+
+void mont_exp_set_u32(mont_exp_t *e, u32 v);    /* e = v, bits = bits(v) */
+u32  mont_exp_bit(const mont_exp_t *e, u32 i);  /* bit i of e */
+
+/* One Montgomery product R = A * B * R^{-1} mod N of the caller's key, for
+ * the exponentiation engine (SW kernel or accelerator behind ctx). R may
+ * alias A or B. Returns 0 on failure (e.g. an accelerator timeout). */
+typedef int (*mont_mul_fn)(void *ctx, const u32 *A, const u32 *B, u32 *R);
+
+/* sliding window: at most 2^(MODEXP_WIN_MAX-1) precomputed odd powers */
+#define MODEXP_WIN_MAX  5U
+
+u32 modexp_window_bits(u32 exp_bits);           /* window width for exp_bits */
+
+/* result = base^E mod N by left-to-right sliding-window exponentiation,
+ * R2 = R^2 mod N. Every product goes through mul. The odd-power table is
+ * static: not reentrant. Returns 0 as soon as a product fails. */
+int modexp_window(mont_mul_fn mul,
+                  void *ctx,
+                  u32 nwords,
+                  const u32 *base,
+                  const mont_exp_t *exp,
+                  const u32 *R2,
+                  u32 *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MONT_SW_H */
@@ -2,17 +2,101 @@
 // -----------------------------------------------------------------------------
 // montgomery_axi.v
 // AXI4-Lite wrapper for montgomery_mul
+//
+// CONTROL.start runs one Montgomery product A*B*R^-1 mod N. With
+// CONTROL.modexp also set, an on-chip sequencer computes the whole
+// right-to-left square-and-multiply A^E mod N instead:
+//     A = base, EXP = exponent words, EXP_BITS = bit length, R^2 from the key
+// x and a stay in local registers between products, and STATUS.done is
+// raised once, when the final result is in RES.
+//
+// For single products CONTROL.asrc / bsrc pick each operand from the A/B
+// window, the previous result, the saved registers X0 / X1, the constant 1
+// or R^2 mod N, and CONTROL.dst can save the result to X0 or X1, so a
+// software-scheduled exponentiation never moves intermediates over AXI.
+// X0 / X1 are the sequencer's x and a registers: modexp jobs overwrite them.
+//
+// A, B, EXP, EXP_BITS and RES exist in 2*NUM_LANES banks.
+// CONTROL.bank picks the bank the AXI windows and STATUS.done refer to and,
+// together with start, the bank the job runs on. A start while the core is
+// busy is queued (one deep) and runs as soon as the current job finishes,
+// so the host can fill one bank while the other is being multiplied.
+//
+// NUM_LANES montgomery_lane instances (sequencer, resident key, core) share
+// the register window, the banks and the queue: a job runs on the lowest
+// idle lane, reading its operands from its bank, and LANE_STATUS /
+// LANE_BANK show what each lane is doing. X0 / X1 and the previous result
+// belong to the lane, so operand forwarding assumes one job at a time.
+//
+// The banks are memories without reset, so A, B and RES map to block RAM
+// and EXP to distributed RAM rather than flip-flops. A lane copies its A / B
+// words in through a shared read port when the job starts, and its result
+// is copied into RES one word per clock before the job counts as done. A
+// and B are write-only over AXI; RES words above KEY_LEN are undefined.
+//
+// N, NPRIME, R^2 mod N and the modulus length live in NUM_KEYS key slots
+// instead (N and R^2 in block RAM, write-only over AXI). CONTROL.slot picks
+// the slot the key windows write to and the slot a job uses. N and R^2 of
+// the last slot used stay resident in registers; a job on another slot (or
+// after that slot was rewritten) first copies them in, one word per clock.
+//
+// KEY_LEN sets the operand length of a slot (R = 2^KEY_LEN). When N_BITS is
+// a multiple of 512 (HWCFG.varlen) it can be any multiple of 512 up to
+// N_BITS, so one instance serves 512 ... N_BITS bit keys: the core stops
+// after KEY_LEN bits and DMA moves KEY_LEN/32 words per operand. Otherwise
+// it stays N_BITS.
+//
+// With CORE_CLK_ASYNC the lanes' cores run on core_clk (a second FCLK, free
+// of the s_axi clock), start / done crossing through synchronizers in
+// montgomery_lane; everything else, the sequencers included, stays on
+// s_axi_aclk and CYCLES still counts s_axi clocks. Otherwise core_clk is
+// unused.
+//
+// irq (level, active high, for IRQ_F2P) is IRQ_STATUS & IRQ_ENABLE. Every
+// finished job sets IRQ_STATUS.done; the host clears it by writing 1.
+//
+// With DMA_EN the m_axi_* master (montgomery_dma, for an S_AXI_HP port) can
+// move a job's operands instead: CONTROL.dma makes the job fetch A, B and N
+// from the DDR descriptor at DMA_DESC in bursts and store RES back to DDR
+// before STATUS.done is raised. HWCFG reports N_BITS, CORE_TYPE, NUM_KEYS,
+// DMA_EN, NUM_LANES, varlen and CORE_CLK_ASYNC so the driver can tell the
+// variants apart.
+//
+// The same engine also walks a ring of descriptors in DDR (RING_BASE,
+// RING_SIZE): the host appends descriptors and writes RING_TAIL, the
+// wrapper prefetches the next job into a free bank while the lanes run,
+// writes each result and completion word back, and advances RING_HEAD /
+// raises IRQ_STATUS.ring per finished descriptor. With one lane entries
+// complete in order; with more, a later one may overtake.
 // -----------------------------------------------------------------------------
 module montgomery_axi #
 (
     parameter integer N_BITS               = 2048,
+    // 0: montgomery_mul      (radix-2, ADD_A/ADD_N/SHIFT, ~3 clk per bit)
+    // 1: montgomery_mul_1cyc (radix-2, one clk per bit)
+    // 2: montgomery_mul_csa  (radix-2, one clk per bit, carry-save T)
+    // 3: montgomery_mul_r4   (radix-4, one clk per two bits)
+    // 4: montgomery_mul_word (radix-2^32 CIOS on DSP48s, uses n_prime)
+    // 5: montgomery_mul_systolic (MWR2MM systolic array, NUM_PE elements)
+    parameter integer CORE_TYPE            = 0,
+    parameter integer NUM_PE               = 16,      // CORE_TYPE 5 only
+    parameter integer NUM_KEYS             = 4,       // key slots, <= 16
+    parameter integer NUM_LANES            = 1,       // cores, <= 8
+    parameter integer DMA_EN               = 0,       // 1: descriptor DMA on m_axi
+    parameter integer CORE_CLK_ASYNC       = 0,       // 1: cores on core_clk
     parameter integer C_S_AXI_DATA_WIDTH   = 32,
-    parameter integer C_S_AXI_ADDR_WIDTH   = 12
+    parameter integer C_S_AXI_ADDR_WIDTH   = 12,
+    parameter integer C_M_AXI_ADDR_WIDTH   = 32,
+    parameter integer C_M_AXI_DATA_WIDTH   = 32       // 32 only
 )
 (
     input  wire                             s_axi_aclk,
     input  wire                             s_axi_aresetn,
 
+    // core clock (CORE_CLK_ASYNC only; tie to s_axi_aclk otherwise)
+    (* X_INTERFACE_INFO = "xilinx.com:signal:clock:1.0 core_clk CLK" *)
+    input  wire                             core_clk,
+
     // write address
     input  wire [C_S_AXI_ADDR_WIDTH-1:0]    s_axi_awaddr,
     input  wire                             s_axi_awvalid,
@@ -38,7 +122,43 @@ module montgomery_axi #
     output reg [C_S_AXI_DATA_WIDTH-1:0]     s_axi_rdata,
     output reg [1:0]                        s_axi_rresp,
     output reg                              s_axi_rvalid,
-    input  wire                             s_axi_rready
+    input  wire                             s_axi_rready,
+
+    // AXI4 master for descriptor DMA (tied off unless DMA_EN)
+    output wire [C_M_AXI_ADDR_WIDTH-1:0]    m_axi_awaddr,
+    output wire [7:0]                       m_axi_awlen,
+    output wire [2:0]                       m_axi_awsize,
+    output wire [1:0]                       m_axi_awburst,
+    output wire [3:0]                       m_axi_awcache,
+    output wire [2:0]                       m_axi_awprot,
+    output wire                             m_axi_awvalid,
+    input  wire                             m_axi_awready,
+    output wire [C_M_AXI_DATA_WIDTH-1:0]    m_axi_wdata,
+    output wire [(C_M_AXI_DATA_WIDTH/8)-1:0] m_axi_wstrb,
+    output wire                             m_axi_wlast,
+    output wire                             m_axi_wvalid,
+    input  wire                             m_axi_wready,
+    input  wire [1:0]                       m_axi_bresp,
+    input  wire                             m_axi_bvalid,
+    output wire                             m_axi_bready,
+    output wire [C_M_AXI_ADDR_WIDTH-1:0]    m_axi_araddr,
+    output wire [7:0]                       m_axi_arlen,
+    output wire [2:0]                       m_axi_arsize,
+    output wire [1:0]                       m_axi_arburst,
+    output wire [3:0]                       m_axi_arcache,
+    output wire [2:0]                       m_axi_arprot,
+    output wire                             m_axi_arvalid,
+    input  wire                             m_axi_arready,
+    input  wire [C_M_AXI_DATA_WIDTH-1:0]    m_axi_rdata,
+    input  wire [1:0]                       m_axi_rresp,
+    input  wire                             m_axi_rlast,
+    input  wire                             m_axi_rvalid,
+    output wire                             m_axi_rready,
+
+    // job finished interrupt
+    (* X_INTERFACE_INFO = "xilinx.com:signal:interrupt:1.0 irq INTERRUPT" *)
+    (* X_INTERFACE_PARAMETER = "SENSITIVITY LEVEL_HIGH" *)
+    output reg                              irq
 );
 
     // -------------------------------------------------------------------------
@@ -48,44 +168,229 @@ module montgomery_axi #
 
     localparam [C_S_AXI_ADDR_WIDTH-1:0] BASE_A       = 12'h000;   // 0x0
     localparam [C_S_AXI_ADDR_WIDTH-1:0] BASE_B       = 12'h200;   // 0x200
-    localparam [C_S_AXI_ADDR_WIDTH-1:0] BASE_N       = 12'h400;   // 0x400
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] BASE_N       = 12'h400;   // 0x400 (key slot)
     localparam [C_S_AXI_ADDR_WIDTH-1:0] BASE_RES     = 12'h600;   // 0x600
     localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_NPRIME  = 12'h800;   // 0x800
     localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_CONTROL = 12'h804;   // 0x804
     localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_STATUS  = 12'h808;   // 0x808
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_CYCLES  = 12'h80C;   // 0x80C
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_EXPBITS = 12'h810;   // 0x810
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_KEYBITS = 12'h814;   // 0x814 (key slot)
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_IRQEN   = 12'h818;   // 0x818
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_IRQSTAT = 12'h81C;   // 0x81C (W1C)
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_DMADESC = 12'h820;   // 0x820
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_HWCFG   = 12'h824;   // 0x824 (RO)
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_RBASE   = 12'h828;   // 0x828
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_RSIZE   = 12'h82C;   // 0x82C
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_RTAIL   = 12'h830;   // 0x830 (doorbell)
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_RHEAD   = 12'h834;   // 0x834 (RO)
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_LSTAT   = 12'h838;   // 0x838 (RO)
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_LBANK   = 12'h83C;   // 0x83C (RO)
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] ADDR_KEYLEN  = 12'h840;   // 0x840 (key slot)
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] BASE_E       = 12'hA00;   // 0xA00
+    localparam [C_S_AXI_ADDR_WIDTH-1:0] BASE_R2      = 12'hC00;   // 0xC00 (key slot)
 
     localparam integer IDX_BASE_A   = BASE_A   / 4;
     localparam integer IDX_BASE_B   = BASE_B   / 4;
     localparam integer IDX_BASE_N   = BASE_N   / 4;
     localparam integer IDX_BASE_RES = BASE_RES / 4;
+    localparam integer IDX_BASE_E   = BASE_E   / 4;
+    localparam integer IDX_BASE_R2  = BASE_R2  / 4;
+
+    localparam integer BIT_W        = $clog2(N_BITS) + 1;
+    localparam integer SLOT_W       = (NUM_KEYS > 1) ? $clog2(NUM_KEYS) : 1;
+    localparam integer KI_W         = $clog2(AXI_NWORDS + 1);
+    localparam integer NUM_BANKS    = 2 * NUM_LANES;
+    localparam integer BANK_W       = $clog2(NUM_BANKS);
+    localparam integer LANE_W       = (NUM_LANES > 1) ? $clog2(NUM_LANES) : 1;
+
+    // KEY_LEN below N_BITS: multiples of 512 (the systolic core also needs
+    // NUM_PE to divide 512)
+    localparam integer VARLEN       = (N_BITS % 512 == 0) &&
+                                      (CORE_TYPE != 5 || 512 % NUM_PE == 0);
+
+    // HWCFG: [15:0] N_BITS, [19:16] CORE_TYPE, [23:20] NUM_KEYS-1, [24] DMA_EN,
+    //        [27:25] NUM_LANES-1, [28] varlen, [29] CORE_CLK_ASYNC
+    localparam [31:0]  HWCFG_VAL    = (N_BITS & 32'hFFFF) |
+                                      ((CORE_TYPE & 32'hF) << 16) |
+                                      (((NUM_KEYS - 1) & 32'hF) << 20) |
+                                      ((DMA_EN != 0) ? 32'h0100_0000 : 32'd0) |
+                                      (((NUM_LANES - 1) & 32'h7) << 25) |
+                                      ((VARLEN != 0) ? 32'h1000_0000 : 32'd0) |
+                                      ((CORE_CLK_ASYNC != 0) ? 32'h2000_0000 : 32'd0);
 
     // -------------------------------------------------------------------------
     // Internal registers / memories
     // -------------------------------------------------------------------------
-    reg [31:0] a_mem [0:AXI_NWORDS-1];
-    reg [31:0] b_mem [0:AXI_NWORDS-1];
-    reg [31:0] n_mem [0:AXI_NWORDS-1];
-    reg [31:0] y_mem [0:AXI_NWORDS-1];
-
-    reg [31:0] n_prime_reg;
-    reg        start_reg;   // level: 1 from CONTROL write until core_done
-    reg        done_reg;    // sticky done
-
-    // Flatten for core
-    wire [N_BITS-1:0] a_vec;
-    wire [N_BITS-1:0] b_vec;
-    wire [N_BITS-1:0] n_vec;
-    wire [N_BITS-1:0] y_vec;
-    wire              core_done;
-
-    genvar gi;
-    generate
-        for (gi = 0; gi < AXI_NWORDS; gi = gi + 1) begin : FLATTEN
-            assign a_vec[32*gi +: 32] = a_mem[gi];
-            assign b_vec[32*gi +: 32] = b_mem[gi];
-            assign n_vec[32*gi +: 32] = n_mem[gi];
+    // NUM_BANKS banks each: bank b holds words [b*AXI_NWORDS +: AXI_NWORDS]
+    // (no reset: A / B / RES are block RAM, EXP distributed RAM)
+    reg [31:0] a_mem [0:NUM_BANKS*AXI_NWORDS-1];
+    reg [31:0] b_mem [0:NUM_BANKS*AXI_NWORDS-1];
+    reg [31:0] y_mem [0:NUM_BANKS*AXI_NWORDS-1];
+    reg [31:0] e_mem [0:NUM_BANKS*AXI_NWORDS-1]; // exponent, LS word first
+
+    reg [31:0] exp_bits_mem [0:NUM_BANKS-1];
+    reg [31:0] cycles_bank  [0:NUM_BANKS-1];     // CYCLES of the last job
+
+    // key slots: slot s holds words [s*AXI_NWORDS +: AXI_NWORDS]
+    reg [31:0] key_n_mem  [0:NUM_KEYS*AXI_NWORDS-1];
+    reg [31:0] key_r2_mem [0:NUM_KEYS*AXI_NWORDS-1];
+    reg [31:0] key_nprime [0:NUM_KEYS-1];
+    reg [31:0] key_bits   [0:NUM_KEYS-1];   // modulus length, for the driver
+    reg [BIT_W-1:0] key_len [0:NUM_KEYS-1]; // KEY_LEN: operand length in bits
+
+    // per lane: the job it runs
+    reg [NUM_LANES-1:0] start_reg;          // level: 1 while the lane is busy
+    reg [NUM_LANES-1:0] mode_exp;           // CONTROL.modexp
+    reg [NUM_LANES-1:0] run_dma;            // CONTROL.dma
+    reg [NUM_LANES-1:0] run_ring;           // came from the descriptor ring
+    reg [BANK_W-1:0]    run_bank    [0:NUM_LANES-1];
+    reg [SLOT_W-1:0]    run_slot    [0:NUM_LANES-1];
+    reg [2:0]           run_asrc    [0:NUM_LANES-1];    // operand sources /
+    reg [2:0]           run_bsrc    [0:NUM_LANES-1];    // result destination
+    reg [1:0]           run_dst     [0:NUM_LANES-1];    // of a plain product
+    reg [31:0]          run_desc    [0:NUM_LANES-1];
+    reg [31:0]          busy_cycles [0:NUM_LANES-1];    // clocks since start
+
+    reg [NUM_BANKS-1:0] done_bank;  // sticky done, per bank
+    reg [1:0]  irq_en;      // IRQ_ENABLE: bit 0 done, bit 1 ring
+    reg [1:0]  irq_pend;    // IRQ_STATUS
+    reg [BANK_W-1:0] host_bank; // bank seen through the AXI windows
+    reg        pend_valid;  // one queued job
+    reg [BANK_W-1:0] pend_bank;
+    reg        pend_exp;
+    reg [2:0]  pend_asrc;
+    reg [2:0]  pend_bsrc;
+    reg [1:0]  pend_dst;
+    reg [SLOT_W-1:0] host_slot; // key slot seen through the key windows
+    reg [SLOT_W-1:0] pend_slot;
+    reg        pend_dma;
+    reg        pend_ring;
+    reg [31:0] dma_desc;    // DMA_DESC
+    reg [31:0] pend_desc;
+    reg        dma_err;     // STATUS.dma_err: last job hit a bus error
+
+    // descriptor ring, indices run modulo ring_size
+    reg [31:0] ring_base;   // RING_BASE
+    reg [15:0] ring_size;   // RING_SIZE (entries, 0: off)
+    reg [15:0] ring_tail;   // RING_TAIL, written by the host
+    reg [15:0] ring_head;   // RING_HEAD, descriptors completed
+    reg [15:0] ring_fetch;  // next descriptor to prefetch
+
+    wire [15:0] ring_head_nx  = (ring_head  + 16'd1 == ring_size) ? 16'd0 : ring_head  + 16'd1;
+    wire [15:0] ring_fetch_nx = (ring_fetch + 16'd1 == ring_size) ? 16'd0 : ring_fetch + 16'd1;
+
+    // descriptor DMA engine state (see "Descriptor DMA" below)
+    localparam [3:0]
+        DJ_IDLE    = 4'd0,
+        DJ_DESC    = 4'd1,      // fetch: descriptor
+        DJ_A       = 4'd2,      //        A / B (EXP for modexp) / N
+        DJ_B       = 4'd3,
+        DJ_N       = 4'd4,
+        DJ_RES     = 4'd5,      // store: result
+        DJ_FLAG    = 4'd6,      //        completion word (ring jobs)
+        DJ_END     = 4'd7,      // store finished
+        DJ_ABORT   = 4'd8;      // fetch of a CONTROL.dma job failed
+
+    reg  [3:0]        dj_state;
+    reg               f_ring;       // fetch: for the ring (else CONTROL.dma)
+    reg  [LANE_W-1:0] f_lane;       //        lane of a CONTROL.dma job
+    reg  [BANK_W-1:0] f_bank;       //        bank / key slot it fills
+    reg  [SLOT_W-1:0] f_slot;
+    reg               f_exp;        //        B address is the exponent
+    reg  [31:0]       dsc_n;
+    reg  [31:0]       dsc_np;
+    reg  [NUM_LANES-1:0] hf_done;   // CONTROL.dma job: operands are in
+    reg  [NUM_BANKS-1:0] st_pend;   // finished DMA / ring job, result not stored
+    reg  [NUM_BANKS-1:0] st_ring;   //   ... and it came from the ring
+    reg               rq_valid;     // prefetched ring job, not queued yet
+    reg  [BANK_W-1:0] rq_bank;
+    reg  [31:0]       rq_ctrl;
+    reg               c_ring;       // store: job being completed
+    reg  [BANK_W-1:0] c_bank;
+    wire              ring_take;    // rq_* moves into the queue
+    wire              dj_ring_start;
+    wire              dma_cmd_done;
+    wire              dma_cmd_err;
+    wire              dma_rd_valid;
+    wire [15:0]       dma_rd_idx;
+    wire [31:0]       dma_rd_data;
+
+    wire [15:0] host_off  = host_bank * AXI_NWORDS;
+    wire [15:0] host_koff = host_slot * AXI_NWORDS;
+    wire [15:0] f_off     = f_bank    * AXI_NWORDS;
+    wire [15:0] f_koff    = f_slot    * AXI_NWORDS;
+
+    // CONTROL.bank: bit 2 is bank[0], bits 20:18 the rest (NUM_LANES > 1)
+    wire [3:0]  wr_bank4  = {s_axi_wdata[20:18], s_axi_wdata[2]};
+    wire [BANK_W-1:0] wr_bank = wr_bank4[BANK_W-1:0];
+    wire [3:0]  host_bank4 = host_bank;
+    wire [3:0]  host_slot4 = host_slot;
+
+    // KEY_LEN write: rounded up to 512, N_BITS for 0 / too long / !VARLEN
+    wire [31:0]      klen_up = (s_axi_wdata + 32'd511) & ~32'd511;
+    wire [BIT_W-1:0] klen_wr = ((VARLEN != 0) && s_axi_wdata != 32'd0 &&
+                                s_axi_wdata <= N_BITS) ? klen_up[BIT_W-1:0] : N_BITS;
+
+    // EXP_BITS writes (host and ring descriptor) saturate at N_BITS: the
+    // lane's bit counter is BIT_W wide and the bank holds N_BITS/32 words
+    wire [31:0]      expb_wr  = (s_axi_wdata > N_BITS) ? N_BITS : s_axi_wdata;
+    wire [31:0]      expb_dma = (dma_rd_data > N_BITS) ? N_BITS : dma_rd_data;
+
+    // lane results / LANE_STATUS / LANE_BANK
+    wire [NUM_LANES-1:0]        lane_done;  // product / modexp of the lane done
+    wire [NUM_LANES*N_BITS-1:0] lane_y;
+    wire [NUM_LANES-1:0]        job_done;   // ... and its result copied to RES
+    reg  [NUM_LANES-1:0]        y_wait;     // lane done, RES copy not finished
+    wire [7:0]                  lane_busy8 = start_reg;
+    wire [7:0]                  lane_wait8 = start_reg & run_dma & ~hf_done;
+    wire [31:0]                 lane_bank_rd;
+
+    // lowest idle lane for the next job, lowest bank that is neither in use
+    // by a lane nor holding an unstored result (ring prefetch target), and
+    // the lane / bank the DMA engine serves next
+    reg                  lane_free;
+    reg  [LANE_W-1:0]    free_lane;
+    reg                  bank_free;
+    reg  [BANK_W-1:0]    free_bank;
+    reg  [NUM_BANKS-1:0] bank_run;
+    reg  [LANE_W-1:0]    hf_lane;       // lowest lane waiting for a DMA fetch
+    reg  [BANK_W-1:0]    st_bank;       // lowest bank with a result to store
+    reg                  f_slot_busy;   // a lane runs on key slot f_slot
+
+    integer sl;
+    integer sb;
+    always @(*) begin
+        lane_free   = 1'b0;
+        free_lane   = {LANE_W{1'b0}};
+        hf_lane     = {LANE_W{1'b0}};
+        f_slot_busy = 1'b0;
+        bank_run    = {NUM_BANKS{1'b0}};
+        for (sl = NUM_LANES-1; sl >= 0; sl = sl - 1) begin
+            if (!start_reg[sl]) begin
+                lane_free = 1'b1;
+                free_lane = sl;
+            end
+            if (start_reg[sl] && run_dma[sl] && !hf_done[sl])
+                hf_lane = sl;
+            if (start_reg[sl] && run_slot[sl] == f_slot)
+                f_slot_busy = 1'b1;
+            if (start_reg[sl])
+                bank_run[run_bank[sl]] = 1'b1;
         end
-    endgenerate
+
+        bank_free = 1'b0;
+        free_bank = {BANK_W{1'b0}};
+        st_bank   = {BANK_W{1'b0}};
+        for (sb = NUM_BANKS-1; sb >= 0; sb = sb - 1) begin
+            if (!bank_run[sb] && !st_pend[sb]) begin
+                bank_free = 1'b1;
+                free_bank = sb;
+            end
+            if (st_pend[sb])
+                st_bank = sb;
+        end
+    end
 
     // -------------------------------------------------------------------------
     // AXI write handshake (independent AW/W channels)
@@ -95,6 +400,13 @@ module montgomery_axi #
     wire                         w_hs  = s_axi_wvalid  && s_axi_wready;
     wire                         wr_en = aw_hs && w_hs;
 
+    // DMA operand beats own the A / B / EXP and N write ports: hold host
+    // writes off while a fetch moves them. A write accepted just before
+    // lands ahead of the first beat (at least three clocks after the
+    // command), and a held-off prefetch of N issues no command.
+    wire                         dma_fill = ((dj_state == DJ_A) || (dj_state == DJ_B) ||
+                                             (dj_state == DJ_N)) && !dj_hold;
+
     always @(posedge s_axi_aclk) begin
         if (!s_axi_aresetn) begin
             s_axi_awready <= 1'b0;
@@ -102,7 +414,7 @@ module montgomery_axi #
             awaddr_reg    <= {C_S_AXI_ADDR_WIDTH{1'b0}};
         end else begin
             // AW channel
-            if (~s_axi_awready && s_axi_awvalid) begin
+            if (~s_axi_awready && s_axi_awvalid && !dma_fill) begin
                 s_axi_awready <= 1'b1;
                 awaddr_reg    <= s_axi_awaddr;
             end else begin
@@ -110,7 +422,7 @@ module montgomery_axi #
             end
 
             // W channel
-            if (~s_axi_wready && s_axi_wvalid) begin
+            if (~s_axi_wready && s_axi_wvalid && !dma_fill) begin
                 s_axi_wready <= 1'b1;
             end else begin
                 s_axi_wready <= 1'b0;
@@ -122,73 +434,291 @@ module montgomery_axi #
     // AXI write logic
     // -------------------------------------------------------------------------
     integer i;
+    integer l;
     integer widx;
 
     always @(posedge s_axi_aclk) begin
         if (!s_axi_aresetn) begin
-            n_prime_reg <= 32'd0;
-            start_reg   <= 1'b0;
-            done_reg    <= 1'b0;
-            for (i = 0; i < AXI_NWORDS; i = i + 1) begin
-                a_mem[i] <= 32'd0;
-                b_mem[i] <= 32'd0;
-                n_mem[i] <= 32'd0;
-                y_mem[i] <= 32'd0;
+            start_reg   <= {NUM_LANES{1'b0}};
+            mode_exp    <= {NUM_LANES{1'b0}};
+            run_dma     <= {NUM_LANES{1'b0}};
+            run_ring    <= {NUM_LANES{1'b0}};
+            for (l = 0; l < NUM_LANES; l = l + 1) begin
+                run_bank[l]    <= {BANK_W{1'b0}};
+                run_slot[l]    <= {SLOT_W{1'b0}};
+                run_asrc[l]    <= 3'd0;
+                run_bsrc[l]    <= 3'd0;
+                run_dst[l]     <= 2'd0;
+                run_desc[l]    <= 32'd0;
+                busy_cycles[l] <= 32'd0;
+            end
+            done_bank   <= {NUM_BANKS{1'b0}};
+            irq_en      <= 2'b00;
+            irq_pend    <= 2'b00;
+            irq         <= 1'b0;
+            host_bank   <= {BANK_W{1'b0}};
+            pend_valid  <= 1'b0;
+            pend_bank   <= {BANK_W{1'b0}};
+            pend_exp    <= 1'b0;
+            pend_asrc   <= 3'd0;
+            pend_bsrc   <= 3'd0;
+            pend_dst    <= 2'd0;
+            host_slot   <= {SLOT_W{1'b0}};
+            pend_slot   <= {SLOT_W{1'b0}};
+            pend_dma    <= 1'b0;
+            pend_ring   <= 1'b0;
+            ring_base   <= 32'd0;
+            ring_size   <= 16'd0;
+            ring_tail   <= 16'd0;
+            ring_head   <= 16'd0;
+            ring_fetch  <= 16'd0;
+            dma_desc    <= 32'd0;
+            pend_desc   <= 32'd0;
+            dma_err     <= 1'b0;
+            for (i = 0; i < NUM_BANKS; i = i + 1) begin
+                exp_bits_mem[i] <= 32'd0;
+                cycles_bank[i]  <= 32'd0;
+            end
+            for (i = 0; i < NUM_KEYS; i = i + 1) begin
+                key_nprime[i] <= 32'd0;
+                key_bits[i]   <= 32'd0;
+                key_len[i]    <= N_BITS;
             end
         end else begin
+            for (l = 0; l < NUM_LANES; l = l + 1) begin
+                if (start_reg[l])
+                    busy_cycles[l] <= busy_cycles[l] + 1'b1;
+            end
+
+            irq <= |(irq_en & irq_pend);
+
+            // launch the queued job on the lowest idle lane; its start_reg
+            // was low for a clock after job_done, so its core is in S_IDLE
+            if (pend_valid && lane_free) begin
+                start_reg[free_lane]   <= 1'b1;
+                run_bank[free_lane]    <= pend_bank;
+                run_slot[free_lane]    <= pend_slot;
+                mode_exp[free_lane]    <= pend_exp;
+                run_asrc[free_lane]    <= pend_asrc;
+                run_bsrc[free_lane]    <= pend_bsrc;
+                run_dst[free_lane]     <= pend_dst;
+                run_dma[free_lane]     <= pend_dma;
+                run_ring[free_lane]    <= pend_ring;
+                run_desc[free_lane]    <= pend_desc;
+                busy_cycles[free_lane] <= 32'd0;
+                dma_err     <= 1'b0;
+                pend_valid  <= 1'b0;
+            end
+
+            // ring descriptor handed to the fetch side
+            if (dj_ring_start)
+                ring_fetch <= ring_fetch_nx;
+
             if (wr_en) begin
                 widx = awaddr_reg[11:2];
 
-                // A
-                if ((widx >= IDX_BASE_A) &&
-                    (widx < IDX_BASE_A + AXI_NWORDS)) begin
+                // A, B, exponent, N and R^2: memories, written below
+                // n_prime
+                if (awaddr_reg[11:0] == ADDR_NPRIME) begin
                     for (i = 0; i < 4; i = i + 1) begin
                         if (s_axi_wstrb[i])
-                            a_mem[widx - IDX_BASE_A][8*i +: 8] <= s_axi_wdata[8*i +: 8];
+                            key_nprime[host_slot][8*i +: 8] <= s_axi_wdata[8*i +: 8];
                     end
                 end
-                // B
-                else if ((widx >= IDX_BASE_B) &&
-                         (widx < IDX_BASE_B + AXI_NWORDS)) begin
-                    for (i = 0; i < 4; i = i + 1) begin
-                        if (s_axi_wstrb[i])
-                            b_mem[widx - IDX_BASE_B][8*i +: 8] <= s_axi_wdata[8*i +: 8];
-                    end
+                // exponent length in bits (<= N_BITS)
+                else if (awaddr_reg[11:0] == ADDR_EXPBITS) begin
+                    exp_bits_mem[host_bank] <= expb_wr;
                 end
-                // N
-                else if ((widx >= IDX_BASE_N) &&
-                         (widx < IDX_BASE_N + AXI_NWORDS)) begin
-                    for (i = 0; i < 4; i = i + 1) begin
-                        if (s_axi_wstrb[i])
-                            n_mem[widx - IDX_BASE_N][8*i +: 8] <= s_axi_wdata[8*i +: 8];
-                    end
+                // modulus length of the key slot
+                else if (awaddr_reg[11:0] == ADDR_KEYBITS) begin
+                    key_bits[host_slot] <= s_axi_wdata;
                 end
-                // n_prime
-                else if (awaddr_reg[11:0] == ADDR_NPRIME) begin
-                    for (i = 0; i < 4; i = i + 1) begin
-                        if (s_axi_wstrb[i])
-                            n_prime_reg[8*i +: 8] <= s_axi_wdata[8*i +: 8];
-                    end
+                // operand length of the key slot
+                else if (awaddr_reg[11:0] == ADDR_KEYLEN) begin
+                    key_len[host_slot] <= klen_wr;
+                end
+                // interrupt enable
+                else if (awaddr_reg[11:0] == ADDR_IRQEN) begin
+                    irq_en <= s_axi_wdata[1:0];
+                end
+                // interrupt status, write 1 to clear
+                else if (awaddr_reg[11:0] == ADDR_IRQSTAT) begin
+                    irq_pend <= irq_pend & ~s_axi_wdata[1:0];
+                end
+                // descriptor address for the next CONTROL.dma start
+                else if (awaddr_reg[11:0] == ADDR_DMADESC) begin
+                    dma_desc <= s_axi_wdata;
+                end
+                // descriptor ring (DMA_EN only); a new size restarts it
+                else if (awaddr_reg[11:0] == ADDR_RBASE) begin
+                    ring_base <= s_axi_wdata;
+                end
+                else if (awaddr_reg[11:0] == ADDR_RSIZE) begin
+                    ring_size  <= (DMA_EN != 0) ? s_axi_wdata[15:0] : 16'd0;
+                    ring_tail  <= 16'd0;
+                    ring_head  <= 16'd0;
+                    ring_fetch <= 16'd0;
+                end
+                else if (awaddr_reg[11:0] == ADDR_RTAIL) begin
+                    ring_tail <= s_axi_wdata[15:0];
                 end
                 // CONTROL
                 else if (awaddr_reg[11:0] == ADDR_CONTROL) begin
                     // bit 0: start pulse (write 1)
+                    // bit 1: modexp (sequence a whole exponentiation)
+                    // bit 2: bank for the AXI windows and for the job
+                    // bit 3: dma (fetch / store through DMA_DESC, DMA_EN only)
+                    // bits 7:4: key slot for the key windows and for the job
+                    // bits 10:8 / 14:12: A / B source, bits 17:16: result
+                    // destination (plain products only, see montgomery_lane)
+                    // bits 20:18: upper bank bits (NUM_LANES > 1)
+                    host_bank <= wr_bank;
+                    host_slot <= s_axi_wdata[4 +: SLOT_W];
                     if (s_axi_wdata[0]) begin
-                        start_reg <= 1'b1;
-                        done_reg  <= 1'b0;
+                        if (lane_free && !pend_valid) begin
+                            // a lane is idle: run now
+                            start_reg[free_lane]   <= 1'b1;
+                            run_bank[free_lane]    <= wr_bank;
+                            run_slot[free_lane]    <= s_axi_wdata[4 +: SLOT_W];
+                            mode_exp[free_lane]    <= s_axi_wdata[1];
+                            run_asrc[free_lane]    <= s_axi_wdata[10:8];
+                            run_bsrc[free_lane]    <= s_axi_wdata[14:12];
+                            run_dst[free_lane]     <= s_axi_wdata[17:16];
+                            run_dma[free_lane]     <= s_axi_wdata[3] && (DMA_EN != 0);
+                            run_ring[free_lane]    <= 1'b0;
+                            run_desc[free_lane]    <= dma_desc;
+                            busy_cycles[free_lane] <= 32'd0;
+                            dma_err     <= 1'b0;
+                            done_bank[wr_bank] <= 1'b0;
+                        end else if (!pend_valid || lane_free) begin
+                            // all lanes busy (or launching the queued job): queue
+                            pend_valid  <= 1'b1;
+                            pend_bank   <= wr_bank;
+                            pend_slot   <= s_axi_wdata[4 +: SLOT_W];
+                            pend_exp    <= s_axi_wdata[1];
+                            pend_asrc   <= s_axi_wdata[10:8];
+                            pend_bsrc   <= s_axi_wdata[14:12];
+                            pend_dst    <= s_axi_wdata[17:16];
+                            pend_dma    <= s_axi_wdata[3] && (DMA_EN != 0);
+                            pend_ring   <= 1'b0;
+                            pend_desc   <= dma_desc;
+                            done_bank[wr_bank] <= 1'b0;
+                        end
+                        // queue full: start is dropped (STATUS.queued)
                     end
                 end
                 // STATUS and result are read-only
             end
 
-            // latch core result when done
-            if (core_done) begin
-                done_reg  <= 1'b1;
-                start_reg <= 1'b0; // let core return to IDLE for next op
-                for (i = 0; i < AXI_NWORDS; i = i + 1) begin
-                    y_mem[i] <= y_vec[32*i +: 32];
+            // prefetched ring job: queue it like a start (the host start
+            // above has priority in the same clock)
+            if (ring_take) begin
+                pend_valid  <= 1'b1;
+                pend_bank   <= rq_bank;
+                pend_slot   <= rq_ctrl[4 +: SLOT_W];
+                pend_exp    <= rq_ctrl[1];
+                pend_asrc   <= rq_ctrl[10:8];
+                pend_bsrc   <= rq_ctrl[14:12];
+                pend_dst    <= rq_ctrl[17:16];
+                pend_dma    <= 1'b0;
+                pend_ring   <= 1'b1;
+            end
+
+            // DMA beats: operands go to the bank memories below, n' rides in
+            // the descriptor when it carries N and ring jobs bring their own
+            // EXP_BITS
+            if (dma_rd_valid && dj_state == DJ_N && dma_rd_idx == 16'd0)
+                key_nprime[f_slot] <= dsc_np;
+            if (dma_rd_valid && dj_state == DJ_DESC && dma_rd_idx == 16'd6 &&
+                f_ring)
+                exp_bits_mem[f_bank] <= expb_dma;
+            if (dma_cmd_done && dma_cmd_err)
+                dma_err <= 1'b1;
+
+            // a lane's result is in its bank; DMA / ring jobs are finished
+            // by the store side
+            for (l = 0; l < NUM_LANES; l = l + 1) begin
+                if (job_done[l]) begin
+                    start_reg[l] <= 1'b0;  // let the core return to IDLE
+                    cycles_bank[run_bank[l]] <= busy_cycles[l] + 1'b1;
+                    if (!run_dma[l] && !run_ring[l]) begin
+                        done_bank[run_bank[l]] <= 1'b1;
+                        irq_pend[0] <= 1'b1;    // wins over a clear in the same clock
+                    end
                 end
             end
+
+            if (dj_state == DJ_END) begin
+                if (c_ring) begin
+                    ring_head   <= ring_head_nx;
+                    irq_pend[1] <= 1'b1;
+                end else begin
+                    done_bank[c_bank] <= 1'b1;
+                    irq_pend[0] <= 1'b1;
+                end
+            end
+
+            // CONTROL.dma job whose fetch failed: finish without running
+            if (dj_state == DJ_ABORT) begin
+                start_reg[f_lane] <= 1'b0;
+                done_bank[f_bank] <= 1'b1;
+                irq_pend[0]       <= 1'b1;
+            end
+        end
+    end
+
+    // key table write port (no reset, so N and R^2 can map to block RAM)
+    wire [9:0] aw_idx   = awaddr_reg[11:2];
+    wire       key_n_we  = wr_en && (aw_idx >= IDX_BASE_N) &&
+                           (aw_idx < IDX_BASE_N + AXI_NWORDS);
+    wire       key_r2_we = wr_en && (aw_idx >= IDX_BASE_R2) &&
+                           (aw_idx < IDX_BASE_R2 + AXI_NWORDS);
+    wire       key_len_we = wr_en && (awaddr_reg[11:0] == ADDR_KEYLEN);
+
+    // N fetched by a DMA job shares the N port (host writes are held off
+    // meanwhile, see dma_fill)
+    wire        dma_n_we    = dma_rd_valid && (dj_state == DJ_N);
+    wire [15:0] key_n_waddr = dma_n_we ? f_koff + dma_rd_idx
+                                       : host_koff + aw_idx - IDX_BASE_N;
+    wire [31:0] key_n_wdata = dma_n_we ? dma_rd_data : s_axi_wdata;
+
+    integer kb;
+    always @(posedge s_axi_aclk) begin
+        for (kb = 0; kb < 4; kb = kb + 1) begin
+            if ((key_n_we && s_axi_wstrb[kb]) || dma_n_we)
+                key_n_mem[key_n_waddr][8*kb +: 8] <= key_n_wdata[8*kb +: 8];
+            if (key_r2_we && s_axi_wstrb[kb])
+                key_r2_mem[host_koff + aw_idx - IDX_BASE_R2][8*kb +: 8] <= s_axi_wdata[8*kb +: 8];
+        end
+    end
+
+    // bank memory write ports (no reset): host writes to the A / B / EXP
+    // windows or DMA operand beats into the bank being fetched, the exponent
+    // replacing B for modexp jobs
+    wire        bank_a_we = wr_en && (aw_idx >= IDX_BASE_A) &&
+                            (aw_idx < IDX_BASE_A + AXI_NWORDS);
+    wire        bank_b_we = wr_en && (aw_idx >= IDX_BASE_B) &&
+                            (aw_idx < IDX_BASE_B + AXI_NWORDS);
+    wire        bank_e_we = wr_en && (aw_idx >= IDX_BASE_E) &&
+                            (aw_idx < IDX_BASE_E + AXI_NWORDS);
+    wire        dma_a_we  = dma_rd_valid && (dj_state == DJ_A);
+    wire        dma_b_we  = dma_rd_valid && (dj_state == DJ_B) && !f_exp;
+    wire        dma_e_we  = dma_rd_valid && (dj_state == DJ_B) && f_exp;
+    wire [15:0] a_waddr   = dma_a_we ? f_off + dma_rd_idx : host_off + aw_idx - IDX_BASE_A;
+    wire [15:0] b_waddr   = dma_b_we ? f_off + dma_rd_idx : host_off + aw_idx - IDX_BASE_B;
+    wire [15:0] e_waddr   = dma_e_we ? f_off + dma_rd_idx : host_off + aw_idx - IDX_BASE_E;
+    wire [31:0] a_wdata   = dma_a_we ? dma_rd_data : s_axi_wdata;
+    wire [31:0] b_wdata   = dma_b_we ? dma_rd_data : s_axi_wdata;
+    wire [31:0] e_wdata   = dma_e_we ? dma_rd_data : s_axi_wdata;
+
+    always @(posedge s_axi_aclk) begin
+        for (kb = 0; kb < 4; kb = kb + 1) begin
+            if ((bank_a_we && s_axi_wstrb[kb]) || dma_a_we)
+                a_mem[a_waddr][8*kb +: 8] <= a_wdata[8*kb +: 8];
+            if ((bank_b_we && s_axi_wstrb[kb]) || dma_b_we)
+                b_mem[b_waddr][8*kb +: 8] <= b_wdata[8*kb +: 8];
+            if ((bank_e_we && s_axi_wstrb[kb]) || dma_e_we)
+                e_mem[e_waddr][8*kb +: 8] <= e_wdata[8*kb +: 8];
         end
     end
 
@@ -227,6 +757,16 @@ module montgomery_axi #
         end
     end
 
+    // RES read port: the word is read while arready is raised, rd_en
+    // forwards it a clock later
+    wire [9:0]  ar_idx = s_axi_araddr[11:2];
+    reg  [31:0] y_host_rd;
+
+    always @(posedge s_axi_aclk) begin
+        if (~s_axi_arready && s_axi_arvalid)
+            y_host_rd <= y_mem[host_off + ar_idx - IDX_BASE_RES];
+    end
+
     integer ridx;
     always @(posedge s_axi_aclk) begin
         if (!s_axi_aresetn) begin
@@ -237,37 +777,92 @@ module montgomery_axi #
             if (rd_en) begin
                 ridx = araddr_reg[11:2];
 
-                // A
-                if ((ridx >= IDX_BASE_A) &&
-                    (ridx < IDX_BASE_A + AXI_NWORDS)) begin
-                    s_axi_rdata <= a_mem[ridx - IDX_BASE_A];
-                end
-                // B
-                else if ((ridx >= IDX_BASE_B) &&
-                         (ridx < IDX_BASE_B + AXI_NWORDS)) begin
-                    s_axi_rdata <= b_mem[ridx - IDX_BASE_B];
+                // A, B (bank memories), N, R^2 (key table): write-only
+                if (((ridx >= IDX_BASE_A) &&
+                     (ridx < IDX_BASE_A + AXI_NWORDS)) ||
+                    ((ridx >= IDX_BASE_B) &&
+                     (ridx < IDX_BASE_B + AXI_NWORDS)) ||
+                    ((ridx >= IDX_BASE_N) &&
+                     (ridx < IDX_BASE_N + AXI_NWORDS)) ||
+                    ((ridx >= IDX_BASE_R2) &&
+                     (ridx < IDX_BASE_R2 + AXI_NWORDS))) begin
+                    s_axi_rdata <= 32'd0;
                 end
-                // N
-                else if ((ridx >= IDX_BASE_N) &&
-                         (ridx < IDX_BASE_N + AXI_NWORDS)) begin
-                    s_axi_rdata <= n_mem[ridx - IDX_BASE_N];
+                // exponent
+                else if ((ridx >= IDX_BASE_E) &&
+                         (ridx < IDX_BASE_E + AXI_NWORDS)) begin
+                    s_axi_rdata <= e_mem[host_off + ridx - IDX_BASE_E];
                 end
                 // n_prime
                 else if (araddr_reg[11:0] == ADDR_NPRIME) begin
-                    s_axi_rdata <= n_prime_reg;
+                    s_axi_rdata <= key_nprime[host_slot];
+                end
+                // EXP_BITS
+                else if (araddr_reg[11:0] == ADDR_EXPBITS) begin
+                    s_axi_rdata <= exp_bits_mem[host_bank];
+                end
+                // KEY_BITS
+                else if (araddr_reg[11:0] == ADDR_KEYBITS) begin
+                    s_axi_rdata <= key_bits[host_slot];
                 end
-                // CONTROL (read as 0)
+                // KEY_LEN
+                else if (araddr_reg[11:0] == ADDR_KEYLEN) begin
+                    s_axi_rdata <= key_len[host_slot];
+                end
+                // CONTROL (start/modexp read as 0)
                 else if (araddr_reg[11:0] == ADDR_CONTROL) begin
-                    s_axi_rdata <= 32'd0;
+                    s_axi_rdata <= {11'd0, host_bank4[3:1], 10'd0, host_slot4,
+                                    1'b0, host_bank4[0], 2'b00};
                 end
-                // STATUS
+                // STATUS: bit 0 done (host bank), 1 busy, 2 queued, 3 dma_err
                 else if (araddr_reg[11:0] == ADDR_STATUS) begin
-                    s_axi_rdata <= {31'd0, done_reg};
+                    s_axi_rdata <= {28'd0, dma_err, pend_valid, |start_reg, done_bank[host_bank]};
+                end
+                // DMA_DESC
+                else if (araddr_reg[11:0] == ADDR_DMADESC) begin
+                    s_axi_rdata <= dma_desc;
+                end
+                // RING_BASE / RING_SIZE / RING_TAIL / RING_HEAD
+                else if (araddr_reg[11:0] == ADDR_RBASE) begin
+                    s_axi_rdata <= ring_base;
+                end
+                else if (araddr_reg[11:0] == ADDR_RSIZE) begin
+                    s_axi_rdata <= {16'd0, ring_size};
+                end
+                else if (araddr_reg[11:0] == ADDR_RTAIL) begin
+                    s_axi_rdata <= {16'd0, ring_tail};
+                end
+                else if (araddr_reg[11:0] == ADDR_RHEAD) begin
+                    s_axi_rdata <= {16'd0, ring_head};
+                end
+                // LANE_STATUS: [7:0] busy, [15:8] waiting for DMA operands
+                else if (araddr_reg[11:0] == ADDR_LSTAT) begin
+                    s_axi_rdata <= {16'd0, lane_wait8, lane_busy8};
+                end
+                // LANE_BANK: bank of each lane's current / last job, 4 bits each
+                else if (araddr_reg[11:0] == ADDR_LBANK) begin
+                    s_axi_rdata <= lane_bank_rd;
+                end
+                // HWCFG: N_BITS, CORE_TYPE, NUM_KEYS-1, DMA_EN, NUM_LANES-1,
+                // varlen, CORE_CLK_ASYNC
+                else if (araddr_reg[11:0] == ADDR_HWCFG) begin
+                    s_axi_rdata <= HWCFG_VAL;
+                end
+                // IRQ_ENABLE / IRQ_STATUS
+                else if (araddr_reg[11:0] == ADDR_IRQEN) begin
+                    s_axi_rdata <= {30'd0, irq_en};
                 end
-                // RESULT
+                else if (araddr_reg[11:0] == ADDR_IRQSTAT) begin
+                    s_axi_rdata <= {30'd0, irq_pend};
+                end
+                // CYCLES (core latency of the last operation on the bank)
+                else if (araddr_reg[11:0] == ADDR_CYCLES) begin
+                    s_axi_rdata <= cycles_bank[host_bank];
+                end
+                // RESULT (block RAM, read at the address handshake)
                 else if ((ridx >= IDX_BASE_RES) &&
                          (ridx < IDX_BASE_RES + AXI_NWORDS)) begin
-                    s_axi_rdata <= y_mem[ridx - IDX_BASE_RES];
+                    s_axi_rdata <= y_host_rd;
                 end
 
                 s_axi_rvalid <= 1'b1;
@@ -279,23 +874,531 @@ module montgomery_axi #
     end
 
     // -------------------------------------------------------------------------
-    // Core instance
+    // Lanes
+    // Each lane (montgomery_lane) runs the job held in its run_* registers on
+    // the operands of run_bank. The key table has one read port: it is lent
+    // to one requesting lane (lowest first) for a whole N / R^2 copy. The
+    // A / B memories have one more, lent the same way for the operand copy,
+    // and one write port into RES serves finished lanes in turn.
     // -------------------------------------------------------------------------
-    montgomery_mul #(
-        .N_BITS (N_BITS)
-    ) u_montgomery_mul (
-        .clk     (s_axi_aclk),
-        .rst     (~s_axi_aresetn),
-        .start   (start_reg),
-        .a_in    (a_vec),
-        .b_in    (b_vec),
-        .n_in    (n_vec),
-        .n_prime (n_prime_reg),
-        .result  (y_vec),
-        .done    (core_done),
-        .dbg_state(),
-        .dbg_bit_idx()
-    );
+    wire [NUM_LANES-1:0]      key_req;
+    wire [NUM_LANES*KI_W-1:0] key_idx_l;
+    wire [NUM_KEYS-1:0]       key_inval;     // slots rewritten this clock
+    reg                       key_busy;
+    reg  [LANE_W-1:0]         key_owner;
+    reg                       key_rd_valid;
+    reg  [KI_W-1:0]           key_rd_idx;    // word arriving on key_*_rd
+    reg  [31:0]               key_n_rd;
+    reg  [31:0]               key_r2_rd;
+
+    wire [KI_W-1:0]           key_idx  = key_idx_l[key_owner*KI_W +: KI_W];
+    wire [15:0]               key_koff = run_slot[key_owner] * AXI_NWORDS;
+
+    always @(posedge s_axi_aclk) begin
+        key_n_rd  <= key_n_mem[key_koff + key_idx];
+        key_r2_rd <= key_r2_mem[key_koff + key_idx];
+    end
+
+    integer kl;
+    always @(posedge s_axi_aclk) begin
+        if (!s_axi_aresetn) begin
+            key_busy     <= 1'b0;
+            key_owner    <= {LANE_W{1'b0}};
+            key_rd_valid <= 1'b0;
+            key_rd_idx   <= {KI_W{1'b0}};
+        end else begin
+            key_rd_valid <= key_busy && key_req[key_owner] && (key_idx < AXI_NWORDS);
+            key_rd_idx   <= key_idx;
+
+            // the owner drops key_req after its last word
+            if (!key_busy) begin
+                for (kl = NUM_LANES-1; kl >= 0; kl = kl - 1) begin
+                    if (key_req[kl]) begin
+                        key_busy  <= 1'b1;
+                        key_owner <= kl;
+                    end
+                end
+            end else if (!key_req[key_owner]) begin
+                key_busy <= 1'b0;
+            end
+        end
+    end
+
+    genvar gk;
+    generate
+        for (gk = 0; gk < NUM_KEYS; gk = gk + 1) begin : G_KEY_INVAL
+            assign key_inval[gk] = ((key_n_we || key_r2_we || key_len_we) && host_slot == gk) ||
+                                   (dma_n_we && f_slot == gk);
+        end
+    endgenerate
+
+    // A / B read port
+    wire [NUM_LANES-1:0]      op_req;
+    wire [NUM_LANES*KI_W-1:0] op_idx_l;
+    reg                       op_busy;
+    reg  [LANE_W-1:0]         op_owner;
+    reg                       op_rd_valid;
+    reg  [KI_W-1:0]           op_rd_idx;     // word arriving on op_*_rd
+    reg  [31:0]               op_a_rd;
+    reg  [31:0]               op_b_rd;
 
+    wire [KI_W-1:0]           op_idx  = op_idx_l[op_owner*KI_W +: KI_W];
+    wire [15:0]               op_off  = run_bank[op_owner] * AXI_NWORDS;
+
+    always @(posedge s_axi_aclk) begin
+        op_a_rd <= a_mem[op_off + op_idx];
+        op_b_rd <= b_mem[op_off + op_idx];
+    end
+
+    integer ol;
+    always @(posedge s_axi_aclk) begin
+        if (!s_axi_aresetn) begin
+            op_busy     <= 1'b0;
+            op_owner    <= {LANE_W{1'b0}};
+            op_rd_valid <= 1'b0;
+            op_rd_idx   <= {KI_W{1'b0}};
+        end else begin
+            op_rd_valid <= op_busy && op_req[op_owner] && (op_idx < AXI_NWORDS);
+            op_rd_idx   <= op_idx;
+
+            // the owner drops op_req after its last word
+            if (!op_busy) begin
+                for (ol = NUM_LANES-1; ol >= 0; ol = ol - 1) begin
+                    if (op_req[ol]) begin
+                        op_busy  <= 1'b1;
+                        op_owner <= ol;
+                    end
+                end
+            end else if (!op_req[op_owner]) begin
+                op_busy <= 1'b0;
+            end
+        end
+    end
+
+    // RES write port: copies KEY_LEN/32 words of a finished lane's result
+    // into its bank, lowest waiting lane first; job_done on the last word
+    reg                       y_busy;
+    reg  [LANE_W-1:0]         y_lane;
+    reg  [KI_W-1:0]           y_idx;
+    reg  [KI_W-1:0]           y_words;
+    reg  [LANE_W-1:0]         y_next;
+
+    wire [BIT_W-1:0]          y_len  = key_len[run_slot[y_next]];
+    wire                      y_last = y_busy && (y_idx == y_words - 1'b1);
+
+    integer yl;
+    always @(*) begin
+        y_next = {LANE_W{1'b0}};
+        for (yl = NUM_LANES-1; yl >= 0; yl = yl - 1) begin
+            if (y_wait[yl])
+                y_next = yl;
+        end
+    end
+
+    always @(posedge s_axi_aclk) begin
+        if (y_busy)
+            y_mem[run_bank[y_lane]*AXI_NWORDS + y_idx] <= lane_y[y_lane*N_BITS + 32*y_idx +: 32];
+    end
+
+    always @(posedge s_axi_aclk) begin
+        if (!s_axi_aresetn) begin
+            y_wait  <= {NUM_LANES{1'b0}};
+            y_busy  <= 1'b0;
+            y_lane  <= {LANE_W{1'b0}};
+            y_idx   <= {KI_W{1'b0}};
+            y_words <= {KI_W{1'b0}};
+        end else begin
+            y_wait  <= (y_wait | lane_done) & ~job_done;
+            if (y_busy) begin
+                y_idx <= y_idx + 1'b1;
+                if (y_last)
+                    y_busy <= 1'b0;
+            end else if (|y_wait) begin
+                y_busy  <= 1'b1;
+                y_lane  <= y_next;
+                y_idx   <= {KI_W{1'b0}};
+                y_words <= y_len[BIT_W-1:5];
+            end
+        end
+    end
+
+    genvar gl;
+    generate
+        for (gl = 0; gl < NUM_LANES; gl = gl + 1) begin : G_LANE
+            wire [15:0]       off = run_bank[gl] * AXI_NWORDS;
+            wire [BIT_W-1:0]  e_idx;
+            wire [31:0]       e_word = e_mem[off + e_idx[BIT_W-1:5]];
+
+            assign job_done[gl] = y_last && (y_lane == gl);
+
+            montgomery_lane #(
+                .N_BITS     (N_BITS),
+                .CORE_TYPE  (CORE_TYPE),
+                .NUM_PE     (NUM_PE),
+                .NUM_KEYS   (NUM_KEYS),
+                .SLOT_W     (SLOT_W),
+                .CORE_ASYNC (CORE_CLK_ASYNC)
+            ) u_lane (
+                .clk          (s_axi_aclk),
+                .rstn         (s_axi_aresetn),
+                .core_clk     (core_clk),
+                // CONTROL.dma jobs start once their operands are in, and
+                // none before the last result is in RES
+                .go           (start_reg[gl] && !y_wait[gl] &&
+                               (!run_dma[gl] || hf_done[gl])),
+                .mode_exp     (mode_exp[gl]),
+                .slot         (run_slot[gl]),
+                .asrc         (run_asrc[gl]),
+                .bsrc         (run_bsrc[gl]),
+                .dst          (run_dst[gl]),
+                .exp_bits     (exp_bits_mem[run_bank[gl]]),
+                .n_prime      (key_nprime[run_slot[gl]]),
+                .n_len        (key_len[run_slot[gl]]),
+                .e_idx        (e_idx),
+                .e_bit        (e_word[e_idx[4:0]]),
+                .key_req      (key_req[gl]),
+                .key_gnt      (key_busy && key_owner == gl),
+                .key_idx      (key_idx_l[gl*KI_W +: KI_W]),
+                .key_rd_valid (key_rd_valid && key_owner == gl),
+                .key_rd_idx   (key_rd_idx),
+                .key_n_rd     (key_n_rd),
+                .key_r2_rd    (key_r2_rd),
+                .key_inval    (key_inval),
+                .op_req       (op_req[gl]),
+                .op_gnt       (op_busy && op_owner == gl),
+                .op_idx       (op_idx_l[gl*KI_W +: KI_W]),
+                .op_rd_valid  (op_rd_valid && op_owner == gl),
+                .op_rd_idx    (op_rd_idx),
+                .op_a_rd      (op_a_rd),
+                .op_b_rd      (op_b_rd),
+                .op_done      (lane_done[gl]),
+                .y_vec        (lane_y[gl*N_BITS +: N_BITS])
+            );
+        end
+
+        // LANE_BANK, 4 bits per lane
+        for (gl = 0; gl < 8; gl = gl + 1) begin : G_LANE_BANK
+            if (gl < NUM_LANES) begin : G_USED
+                assign lane_bank_rd[4*gl +: 4] = run_bank[gl];
+            end else begin : G_NONE
+                assign lane_bank_rd[4*gl +: 4] = 4'd0;
+            end
+        end
+    endgenerate
+
+    // -------------------------------------------------------------------------
+    // Descriptor DMA (DMA_EN)
+    // Descriptors are 8 words:
+    //   word 0  ctrl, CONTROL layout (modexp, slot, asrc, bsrc, dst); ring only
+    //   word 1  A address           word 2  B address (EXP for modexp)
+    //   word 3  N address           word 4  result address
+    //   word 5  n' (used with N)    word 6  EXP_BITS (ring only)
+    //   word 7  completion word: the engine writes {err, 1} when a ring job
+    //           is finished, the host clears it when posting
+    // Address 0 skips that transfer (operand already on chip, result left in
+    // RES only). A, B / EXP, N and the result are KEY_LEN/32 words of the
+    // job's key slot.
+    //
+    // One engine serves three kinds of work, in this priority:
+    //   store     result (and completion word) of a finished DMA / ring job,
+    //             then done / IRQ_STATUS (CONTROL.dma) or RING_HEAD /
+    //             IRQ_STATUS.ring; one job at a time, lowest bank first
+    //   fetch     operands of a started CONTROL.dma job into its bank; its
+    //             lane waits for them. A bus error ends the job without
+    //             running the core (STATUS.dma_err).
+    //   prefetch  the next ring descriptor into a free bank; it then sits in
+    //             the start queue, so an idle lane starts it at once and a
+    //             busy one two clocks after its job finishes. N for a slot a
+    //             lane is using waits until no lane is. A bus error completes
+    //             the descriptor with err set, after the jobs in front of it.
+    // With one lane ring entries therefore complete in order. Ring jobs pick
+    // banks themselves: no direct starts while RING_HEAD != RING_TAIL.
+    // -------------------------------------------------------------------------
+    reg               dj_issued;    // command of this phase handed over
+    reg  [31:0]       f_desc;       // descriptor being fetched
+    reg  [31:0]       dsc_a;
+    reg  [31:0]       dsc_b;
+    reg  [31:0]       res_addr_bank  [0:NUM_BANKS-1];   // per bank: result address
+    reg  [31:0]       desc_addr_bank [0:NUM_BANKS-1];   //   descriptor address
+    reg               e_pend;       // ring descriptor that failed to fetch
+    reg  [31:0]       e_desc;
+    reg  [31:0]       c_res;
+    reg  [31:0]       c_desc;
+    reg               c_err;
+    reg  [15:0]       st_words [0:NUM_BANKS-1];   // per bank: KEY_LEN/32 of its job
+    reg  [15:0]       c_words;
+
+    wire              dma_cmd_ready;
+    wire [15:0]       dma_wr_idx;
+    wire [15:0]       c_off       = c_bank * AXI_NWORDS;
+    reg  [31:0]       y_dma_rd;     // RES word at dma_wr_idx
+    wire [31:0]       dma_wr_data = (dj_state == DJ_FLAG) ? {30'd0, c_err, 1'b1} : y_dma_rd;
+
+    // RES store read port, one word ahead: the address is the index the
+    // DMA master moves to at this edge, so y_dma_rd follows dma_wr_idx
+    // (which is reset at least two clocks before the first W beat)
+    always @(posedge s_axi_aclk) begin
+        y_dma_rd <= y_mem[c_off + dma_wr_idx + (m_axi_wvalid && m_axi_wready)];
+    end
+
+    // ring jobs ahead of a failed descriptor complete first
+    wire              ring_ahead = |(start_reg & run_ring) || (pend_valid && pend_ring);
+    wire              host_fetch = |(start_reg & run_dma & ~hf_done);
+    wire              e_go       = e_pend && !ring_ahead;
+    wire              ring_go    = (ring_size != 16'd0) && (ring_fetch != ring_tail) &&
+                                   !rq_valid && !pend_valid && !e_pend && bank_free;
+
+    assign dj_ring_start = (dj_state == DJ_IDLE) && !(|st_pend) && !e_go &&
+                           !host_fetch && ring_go;
+    assign ring_take     = rq_valid && !pend_valid &&
+                           !(wr_en && awaddr_reg[11:0] == ADDR_CONTROL && s_axi_wdata[0]);
+
+    wire              dj_xfer  = (dj_state == DJ_DESC) || (dj_state == DJ_A)   ||
+                                 (dj_state == DJ_B)    || (dj_state == DJ_N)   ||
+                                 (dj_state == DJ_RES)  || (dj_state == DJ_FLAG);
+    wire [31:0]       dj_addr  = (dj_state == DJ_DESC) ? f_desc :
+                                 (dj_state == DJ_A)    ? dsc_a  :
+                                 (dj_state == DJ_B)    ? dsc_b  :
+                                 (dj_state == DJ_N)    ? dsc_n  :
+                                 (dj_state == DJ_RES)  ? c_res  : c_desc + 32'd28;
+    wire              dj_skip  = (dj_state == DJ_RES)  ? (c_err || c_res == 32'd0) :
+                                 (dj_state == DJ_FLAG) ? !c_ring :
+                                 (dj_state != DJ_DESC) && (dj_addr == 32'd0);
+    wire [3:0]        dj_next  = (dj_state == DJ_DESC) ? DJ_A    :
+                                 (dj_state == DJ_A)    ? DJ_B    :
+                                 (dj_state == DJ_B)    ? DJ_N    :
+                                 (dj_state == DJ_RES)  ? DJ_FLAG :
+                                 (dj_state == DJ_FLAG) ? DJ_END  : DJ_IDLE;
+    // a prefetch may not load a key slot a lane is using
+    wire              dj_hold  = (dj_state == DJ_N) && f_ring && f_slot_busy;
+    wire              dma_cmd_valid = dj_xfer && !dj_skip && !dj_hold && !dj_issued;
+    wire              dma_cmd_write = (dj_state == DJ_RES) || (dj_state == DJ_FLAG);
+    // operands and result are KEY_LEN/32 words of the job's key slot
+    wire [15:0]       f_words       = key_len[f_slot] >> 5;
+    wire [15:0]       dma_cmd_words = (dj_state == DJ_DESC) ? 16'd8   :
+                                      (dj_state == DJ_FLAG) ? 16'd1   :
+                                      (dj_state == DJ_RES)  ? c_words : f_words;
+
+    integer eb;
+    always @(posedge s_axi_aclk) begin
+        if (!s_axi_aresetn) begin
+            dj_state  <= DJ_IDLE;
+            dj_issued <= 1'b0;
+            f_ring    <= 1'b0;
+            f_lane    <= {LANE_W{1'b0}};
+            f_bank    <= {BANK_W{1'b0}};
+            f_slot    <= {SLOT_W{1'b0}};
+            f_exp     <= 1'b0;
+            f_desc    <= 32'd0;
+            dsc_a     <= 32'd0;
+            dsc_b     <= 32'd0;
+            dsc_n     <= 32'd0;
+            dsc_np    <= 32'd0;
+            hf_done   <= {NUM_LANES{1'b0}};
+            rq_valid  <= 1'b0;
+            rq_bank   <= {BANK_W{1'b0}};
+            rq_ctrl   <= 32'd0;
+            st_pend   <= {NUM_BANKS{1'b0}};
+            st_ring   <= {NUM_BANKS{1'b0}};
+            e_pend    <= 1'b0;
+            e_desc    <= 32'd0;
+            c_ring    <= 1'b0;
+            c_bank    <= {BANK_W{1'b0}};
+            c_res     <= 32'd0;
+            c_desc    <= 32'd0;
+            c_err     <= 1'b0;
+            c_words   <= AXI_NWORDS;
+            for (eb = 0; eb < NUM_BANKS; eb = eb + 1) begin
+                res_addr_bank[eb]  <= 32'd0;
+                desc_addr_bank[eb] <= 32'd0;
+                st_words[eb]       <= AXI_NWORDS;
+            end
+        end else begin
+            if (dma_rd_valid && dj_state == DJ_DESC) begin
+                case (dma_rd_idx[2:0])
+                    3'd0: if (f_ring) begin
+                              rq_ctrl <= dma_rd_data;
+                              f_slot  <= dma_rd_data[4 +: SLOT_W];
+                              f_exp   <= dma_rd_data[1];
+                          end
+                    3'd1: dsc_a <= dma_rd_data;
+                    3'd2: dsc_b <= dma_rd_data;
+                    3'd3: dsc_n <= dma_rd_data;
+                    3'd4: res_addr_bank[f_bank] <= dma_rd_data;
+                    3'd5: dsc_np <= dma_rd_data;
+                    default: ;
+                endcase
+            end
+
+            if (ring_take)
+                rq_valid <= 1'b0;
+
+            case (dj_state)
+                DJ_IDLE: begin
+                    if (|st_pend) begin
+                        st_pend[st_bank] <= 1'b0;
+                        c_ring   <= st_ring[st_bank];
+                        c_bank   <= st_bank;
+                        c_res    <= res_addr_bank[st_bank];
+                        c_desc   <= desc_addr_bank[st_bank];
+                        c_words  <= st_words[st_bank];
+                        c_err    <= 1'b0;
+                        dj_state <= DJ_RES;
+                    end else if (e_go) begin
+                        e_pend   <= 1'b0;
+                        c_ring   <= 1'b1;
+                        c_desc   <= e_desc;
+                        c_err    <= 1'b1;
+                        dj_state <= DJ_FLAG;
+                    end else if (host_fetch) begin
+                        f_ring   <= 1'b0;
+                        f_lane   <= hf_lane;
+                        f_bank   <= run_bank[hf_lane];
+                        f_slot   <= run_slot[hf_lane];
+                        f_exp    <= mode_exp[hf_lane];
+                        f_desc   <= run_desc[hf_lane];
+                        dj_state <= DJ_DESC;
+                    end else if (ring_go) begin
+                        // slot / modexp come with the descriptor
+                        f_ring   <= 1'b1;
+                        f_bank   <= free_bank;
+                        f_desc   <= ring_base + {ring_fetch, 5'd0};
+                        desc_addr_bank[free_bank] <= ring_base + {ring_fetch, 5'd0};
+                        dj_state <= DJ_DESC;
+                    end
+                end
+
+                DJ_END, DJ_ABORT:
+                    dj_state <= DJ_IDLE;
+
+                default: begin      // transfers
+                    if (dj_skip || (dj_issued && dma_cmd_done && !dma_cmd_err)) begin
+                        dj_issued <= 1'b0;
+                        dj_state  <= dj_next;
+                        if (dj_state == DJ_N) begin
+                            if (f_ring) begin
+                                rq_valid <= 1'b1;
+                                rq_bank  <= f_bank;
+                            end else begin
+                                hf_done[f_lane] <= 1'b1;
+                            end
+                        end
+                    end else if (dj_issued && dma_cmd_done) begin
+                        // bus error
+                        dj_issued <= 1'b0;
+                        if (dj_state == DJ_RES) begin
+                            c_err    <= 1'b1;
+                            dj_state <= DJ_FLAG;
+                        end else if (dj_state == DJ_FLAG) begin
+                            dj_state <= DJ_END;
+                        end else if (f_ring) begin
+                            e_pend   <= 1'b1;
+                            e_desc   <= f_desc;
+                            dj_state <= DJ_IDLE;
+                        end else begin
+                            dj_state <= DJ_ABORT;
+                        end
+                    end else if (!dj_issued && !dj_hold && dma_cmd_ready) begin
+                        dj_issued <= 1'b1;
+                    end
+                end
+            endcase
+
+            // hand finished DMA / ring jobs to the store side; their banks
+            // stay busy until stored
+            for (eb = 0; eb < NUM_LANES; eb = eb + 1) begin
+                if (job_done[eb]) begin
+                    hf_done[eb] <= 1'b0;
+                    if (run_dma[eb] || run_ring[eb]) begin
+                        st_pend[run_bank[eb]]  <= 1'b1;
+                        st_ring[run_bank[eb]]  <= run_ring[eb];
+                        st_words[run_bank[eb]] <= key_len[run_slot[eb]] >> 5;
+                    end
+                end
+            end
+        end
+    end
+
+    generate
+        if (DMA_EN != 0) begin : G_DMA
+            montgomery_dma #(
+                .C_M_AXI_ADDR_WIDTH (C_M_AXI_ADDR_WIDTH),
+                .C_M_AXI_DATA_WIDTH (C_M_AXI_DATA_WIDTH)
+            ) u_dma (
+                .clk           (s_axi_aclk),
+                .rstn          (s_axi_aresetn),
+                .cmd_valid     (dma_cmd_valid),
+                .cmd_write     (dma_cmd_write),
+                .cmd_addr      (dj_addr[C_M_AXI_ADDR_WIDTH-1:0]),
+                .cmd_words     (dma_cmd_words),
+                .cmd_ready     (dma_cmd_ready),
+                .cmd_done      (dma_cmd_done),
+                .cmd_err       (dma_cmd_err),
+                .rd_valid      (dma_rd_valid),
+                .rd_idx        (dma_rd_idx),
+                .rd_data       (dma_rd_data),
+                .wr_idx        (dma_wr_idx),
+                .wr_data       (dma_wr_data),
+                .m_axi_awaddr  (m_axi_awaddr),
+                .m_axi_awlen   (m_axi_awlen),
+                .m_axi_awsize  (m_axi_awsize),
+                .m_axi_awburst (m_axi_awburst),
+                .m_axi_awcache (m_axi_awcache),
+                .m_axi_awprot  (m_axi_awprot),
+                .m_axi_awvalid (m_axi_awvalid),
+                .m_axi_awready (m_axi_awready),
+                .m_axi_wdata   (m_axi_wdata),
+                .m_axi_wstrb   (m_axi_wstrb),
+                .m_axi_wlast   (m_axi_wlast),
+                .m_axi_wvalid  (m_axi_wvalid),
+                .m_axi_wready  (m_axi_wready),
+                .m_axi_bresp   (m_axi_bresp),
+                .m_axi_bvalid  (m_axi_bvalid),
+                .m_axi_bready  (m_axi_bready),
+                .m_axi_araddr  (m_axi_araddr),
+                .m_axi_arlen   (m_axi_arlen),
+                .m_axi_arsize  (m_axi_arsize),
+                .m_axi_arburst (m_axi_arburst),
+                .m_axi_arcache (m_axi_arcache),
+                .m_axi_arprot  (m_axi_arprot),
+                .m_axi_arvalid (m_axi_arvalid),
+                .m_axi_arready (m_axi_arready),
+                .m_axi_rdata   (m_axi_rdata),
+                .m_axi_rresp   (m_axi_rresp),
+                .m_axi_rlast   (m_axi_rlast),
+                .m_axi_rvalid  (m_axi_rvalid),
+                .m_axi_rready  (m_axi_rready)
+            );
+        end else begin : G_NO_DMA
+            assign dma_cmd_ready = 1'b0;
+            assign dma_cmd_done  = 1'b0;
+            assign dma_cmd_err   = 1'b0;
+            assign dma_rd_valid  = 1'b0;
+            assign dma_rd_idx    = 16'd0;
+            assign dma_rd_data   = 32'd0;
+            assign dma_wr_idx    = 16'd0;
+
+            assign m_axi_awaddr  = {C_M_AXI_ADDR_WIDTH{1'b0}};
+            assign m_axi_awlen   = 8'd0;
+            assign m_axi_awsize  = 3'b010;
+            assign m_axi_awburst = 2'b01;
+            assign m_axi_awcache = 4'b0011;
+            assign m_axi_awprot  = 3'b000;
+            assign m_axi_awvalid = 1'b0;
+            assign m_axi_wdata   = {C_M_AXI_DATA_WIDTH{1'b0}};
+            assign m_axi_wstrb   = {(C_M_AXI_DATA_WIDTH/8){1'b0}};
+            assign m_axi_wlast   = 1'b0;
+            assign m_axi_wvalid  = 1'b0;
+            assign m_axi_bready  = 1'b0;
+            assign m_axi_araddr  = {C_M_AXI_ADDR_WIDTH{1'b0}};
+            assign m_axi_arlen   = 8'd0;
+            assign m_axi_arsize  = 3'b010;
+            assign m_axi_arburst = 2'b01;
+            assign m_axi_arcache = 4'b0011;
+            assign m_axi_arprot  = 3'b000;
+            assign m_axi_arvalid = 1'b0;
+            assign m_axi_rready  = 1'b0;
+        end
+    endgenerate
 
 endmodule
@@ -0,0 +1,236 @@
+`timescale 1ns / 1ps
+// -----------------------------------------------------------------------------
+// montgomery_dma.v
+// AXI4 burst master for montgomery_axi (operand fetch / result store in DDR)
+//
+// One command moves cmd_words 32-bit words between DDR at cmd_addr and the
+// wrapper: reads hand every beat out on rd_valid / rd_idx / rd_data, writes
+// take the data of word wr_idx from wr_data in the same clock. Commands are
+// split into INCR bursts of at most 256 beats that never cross a 4 KB
+// boundary; one burst is outstanding at a time.
+//
+// cmd_done pulses after the last read beat or the last write response;
+// cmd_err is valid with it and reports any SLVERR / DECERR on the way.
+// -----------------------------------------------------------------------------
+module montgomery_dma #
+(
+    parameter integer C_M_AXI_ADDR_WIDTH = 32,
+    parameter integer C_M_AXI_DATA_WIDTH = 32     // 32 only
+)
+(
+    input  wire                              clk,
+    input  wire                              rstn,
+
+    // command (accepted in idle, cmd_ready)
+    input  wire                              cmd_valid,
+    input  wire                              cmd_write,  // 1: wrapper -> DDR
+    input  wire [C_M_AXI_ADDR_WIDTH-1:0]     cmd_addr,   // word aligned
+    input  wire [15:0]                       cmd_words,  // >= 1
+    output wire                              cmd_ready,
+    output reg                               cmd_done,
+    output reg                               cmd_err,
+
+    // read beats
+    output wire                              rd_valid,
+    output wire [15:0]                       rd_idx,
+    output wire [31:0]                       rd_data,
+
+    // write beats
+    output wire [15:0]                       wr_idx,
+    input  wire [31:0]                       wr_data,
+
+    // AXI4 master: write address
+    output wire [C_M_AXI_ADDR_WIDTH-1:0]     m_axi_awaddr,
+    output wire [7:0]                        m_axi_awlen,
+    output wire [2:0]                        m_axi_awsize,
+    output wire [1:0]                        m_axi_awburst,
+    output wire [3:0]                        m_axi_awcache,
+    output wire [2:0]                        m_axi_awprot,
+    output reg                               m_axi_awvalid,
+    input  wire                              m_axi_awready,
+
+    // write data
+    output wire [C_M_AXI_DATA_WIDTH-1:0]     m_axi_wdata,
+    output wire [(C_M_AXI_DATA_WIDTH/8)-1:0] m_axi_wstrb,
+    output wire                              m_axi_wlast,
+    output reg                               m_axi_wvalid,
+    input  wire                              m_axi_wready,
+
+    // write response
+    input  wire [1:0]                        m_axi_bresp,
+    input  wire                              m_axi_bvalid,
+    output reg                               m_axi_bready,
+
+    // read address
+    output wire [C_M_AXI_ADDR_WIDTH-1:0]     m_axi_araddr,
+    output wire [7:0]                        m_axi_arlen,
+    output wire [2:0]                        m_axi_arsize,
+    output wire [1:0]                        m_axi_arburst,
+    output wire [3:0]                        m_axi_arcache,
+    output wire [2:0]                        m_axi_arprot,
+    output reg                               m_axi_arvalid,
+    input  wire                              m_axi_arready,
+
+    // read data
+    input  wire [C_M_AXI_DATA_WIDTH-1:0]     m_axi_rdata,
+    input  wire [1:0]                        m_axi_rresp,
+    input  wire                              m_axi_rlast,
+    input  wire                              m_axi_rvalid,
+    output reg                               m_axi_rready
+);
+
+    localparam [2:0]
+        D_IDLE = 3'd0,
+        D_AR   = 3'd1,      // read address
+        D_R    = 3'd2,      // read beats
+        D_AW   = 3'd3,      // write address
+        D_W    = 3'd4,      // write beats
+        D_B    = 3'd5,      // write response
+        D_DONE = 3'd6;
+
+    reg [2:0]                    state;
+    reg [C_M_AXI_ADDR_WIDTH-1:0] cur_addr;   // address of word idx
+    reg [C_M_AXI_ADDR_WIDTH-1:0] burst_addr;
+    reg [15:0]                   left;       // words not yet transferred
+    reg [15:0]                   idx;        // words transferred
+    reg [8:0]                    burst_left; // beats left in this burst
+    reg [7:0]                    burst_len;  // AxLEN of this burst
+
+    // next burst: up to 256 beats, up to the 4 KB boundary, up to left
+    wire [12:0] bytes_4k = 13'h1000 - {1'b0, cur_addr[11:0]};
+    wire [15:0] words_4k = {5'd0, bytes_4k[12:2]};
+    wire [15:0] lim_4k   = (left < words_4k) ? left : words_4k;
+    wire [15:0] beats    = (lim_4k > 16'd256) ? 16'd256 : lim_4k;
+
+    assign cmd_ready     = (state == D_IDLE);
+
+    assign rd_valid      = (state == D_R) && m_axi_rvalid && m_axi_rready;
+    assign rd_idx        = idx;
+    assign rd_data       = m_axi_rdata[31:0];
+    assign wr_idx        = idx;
+
+    assign m_axi_araddr  = burst_addr;
+    assign m_axi_arlen   = burst_len;
+    assign m_axi_arsize  = 3'b010;      // 4 bytes per beat
+    assign m_axi_arburst = 2'b01;       // INCR
+    assign m_axi_arcache = 4'b0011;     // normal, non-cacheable, bufferable
+    assign m_axi_arprot  = 3'b000;
+
+    assign m_axi_awaddr  = burst_addr;
+    assign m_axi_awlen   = burst_len;
+    assign m_axi_awsize  = 3'b010;
+    assign m_axi_awburst = 2'b01;
+    assign m_axi_awcache = 4'b0011;
+    assign m_axi_awprot  = 3'b000;
+
+    assign m_axi_wdata   = wr_data;
+    assign m_axi_wstrb   = {(C_M_AXI_DATA_WIDTH/8){1'b1}};
+    assign m_axi_wlast   = (burst_left == 9'd1);
+
+    always @(posedge clk) begin
+        if (!rstn) begin
+            state         <= D_IDLE;
+            cur_addr      <= {C_M_AXI_ADDR_WIDTH{1'b0}};
+            burst_addr    <= {C_M_AXI_ADDR_WIDTH{1'b0}};
+            left          <= 16'd0;
+            idx           <= 16'd0;
+            burst_left    <= 9'd0;
+            burst_len     <= 8'd0;
+            cmd_done      <= 1'b0;
+            cmd_err       <= 1'b0;
+            m_axi_awvalid <= 1'b0;
+            m_axi_wvalid  <= 1'b0;
+            m_axi_bready  <= 1'b0;
+            m_axi_arvalid <= 1'b0;
+            m_axi_rready  <= 1'b0;
+        end else begin
+            cmd_done <= 1'b0;
+
+            case (state)
+                D_IDLE: begin
+                    if (cmd_valid) begin
+                        cur_addr <= cmd_addr;
+                        left     <= cmd_words;
+                        idx      <= 16'd0;
+                        cmd_err  <= 1'b0;
+                        state    <= cmd_write ? D_AW : D_AR;
+                    end
+                end
+
+                // address phases: size the burst from cur_addr / left on
+                // entry (valid low), then hold it until accepted
+                D_AR: begin
+                    if (!m_axi_arvalid) begin
+                        burst_addr    <= cur_addr;
+                        burst_len     <= beats[7:0] - 8'd1;
+                        burst_left    <= beats[8:0];
+                        m_axi_arvalid <= 1'b1;
+                    end else if (m_axi_arready) begin
+                        m_axi_arvalid <= 1'b0;
+                        m_axi_rready  <= 1'b1;
+                        state         <= D_R;
+                    end
+                end
+
+                D_R: begin
+                    if (m_axi_rvalid) begin
+                        if (m_axi_rresp[1])
+                            cmd_err <= 1'b1;
+                        idx        <= idx + 1'b1;
+                        left       <= left - 1'b1;
+                        cur_addr   <= cur_addr + 3'd4;
+                        burst_left <= burst_left - 1'b1;
+                        if (m_axi_rlast || burst_left == 9'd1) begin
+                            m_axi_rready <= 1'b0;
+                            state        <= (left == 16'd1) ? D_DONE : D_AR;
+                        end
+                    end
+                end
+
+                D_AW: begin
+                    if (!m_axi_awvalid) begin
+                        burst_addr    <= cur_addr;
+                        burst_len     <= beats[7:0] - 8'd1;
+                        burst_left    <= beats[8:0];
+                        m_axi_awvalid <= 1'b1;
+                    end else if (m_axi_awready) begin
+                        m_axi_awvalid <= 1'b0;
+                        m_axi_wvalid  <= 1'b1;
+                        state         <= D_W;
+                    end
+                end
+
+                D_W: begin
+                    if (m_axi_wready) begin
+                        idx        <= idx + 1'b1;
+                        left       <= left - 1'b1;
+                        cur_addr   <= cur_addr + 3'd4;
+                        burst_left <= burst_left - 1'b1;
+                        if (burst_left == 9'd1) begin
+                            m_axi_wvalid <= 1'b0;
+                            m_axi_bready <= 1'b1;
+                            state        <= D_B;
+                        end
+                    end
+                end
+
+                D_B: begin
+                    if (m_axi_bvalid) begin
+                        if (m_axi_bresp[1])
+                            cmd_err <= 1'b1;
+                        m_axi_bready <= 1'b0;
+                        state        <= (left == 16'd0) ? D_DONE : D_AW;
+                    end
+                end
+
+                D_DONE: begin
+                    cmd_done <= 1'b1;
+                    state    <= D_IDLE;
+                end
+
+                default: state <= D_IDLE;
+            endcase
+        end
+    end
+
+endmodule
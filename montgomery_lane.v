@@ -0,0 +1,471 @@
+`timescale 1ns / 1ps
+// -----------------------------------------------------------------------------
+// montgomery_lane.v
+// One job lane of montgomery_axi: job sequencer, resident key and core
+//
+// The wrapper holds the job's parameters steady while go is high; the lane
+// runs it and pulses op_done with the result on y_vec (held until the next
+// job). Every job first copies its A / B words out of the bank memory and
+// makes sure N and R^2 of its key slot are resident (SEQ_LOAD), then runs
+// either one plain product (OP_PLAIN, operands from asrc / bsrc) or the
+// modexp sequence:
+//   x = mont(1, R^2)              x = R mod N
+//   a = mont(A, R^2)              a = base * R mod N
+//   for i in 0 .. EXP_BITS-1:
+//       if e[i]:         x = mont(x, a)
+//       if i < bits-1:   a = mont(a, a)
+//   RES = mont(x, 1)
+//
+// The key table has one read port for all lanes: key_req asks for it,
+// key_idx is only advanced while key_gnt is high and the words come back
+// one clock later on key_rd_*. key_inval marks slots rewritten this clock,
+// so a resident copy of one of them is dropped.
+//
+// The A / B bank memory is block RAM with one read port for all lanes as
+// well (op_req / op_gnt / op_rd_*, A and B at the same word). The copy is
+// skipped for a plain product that takes neither operand from SRC_MEM, so
+// products chained through X0 / X1 / RES do not pay for it.
+//
+// With CORE_ASYNC the core runs on core_clk. start and done then cross in a
+// four-phase handshake through two-flop synchronizers: the sequencer only
+// raises start once the synchronized done is low, so the core has seen the
+// previous start drop. The operand, key and length buses are held from
+// before start rises until done is back, and the result from done until the
+// next start, so they cross as they are (constrain them with
+// set_max_delay -datapath_only, see README).
+//
+// n_len is the KEY_LEN of the job's slot. Only its n_len/32 words are copied
+// and the core operands are masked to them, so stale words above a shorter
+// key never reach the core.
+// -----------------------------------------------------------------------------
+module montgomery_lane #
+(
+    parameter integer N_BITS     = 2048,
+    parameter integer CORE_TYPE  = 0,         // see montgomery_axi
+    parameter integer NUM_PE     = 16,        // CORE_TYPE 5 only
+    parameter integer NUM_KEYS   = 4,
+    parameter integer SLOT_W     = 2,
+    parameter integer CORE_ASYNC = 0          // 1: core on core_clk
+)
+(
+    input  wire                         clk,
+    input  wire                         rstn,
+    input  wire                         core_clk,   // CORE_ASYNC only
+
+    // job, held while go is high; go drops for at least a clock after op_done
+    input  wire                         go,
+    input  wire                         mode_exp,
+    input  wire [SLOT_W-1:0]            slot,
+    input  wire [2:0]                   asrc,
+    input  wire [2:0]                   bsrc,
+    input  wire [1:0]                   dst,
+    input  wire [31:0]                  exp_bits,
+    input  wire [31:0]                  n_prime,
+    input  wire [$clog2(N_BITS):0]      n_len,      // modulus length in bits
+    output wire [$clog2(N_BITS):0]      e_idx,      // exponent bit wanted on e_bit
+    input  wire                         e_bit,
+
+    // key table read port
+    output wire                         key_req,
+    input  wire                         key_gnt,
+    output reg  [$clog2(N_BITS/32+1)-1:0] key_idx,  // word to read
+    input  wire                         key_rd_valid,
+    input  wire [$clog2(N_BITS/32+1)-1:0] key_rd_idx,
+    input  wire [31:0]                  key_n_rd,
+    input  wire [31:0]                  key_r2_rd,
+    input  wire [NUM_KEYS-1:0]          key_inval,
+
+    // A / B bank memory read port, same protocol as the key table
+    output wire                         op_req,
+    input  wire                         op_gnt,
+    output reg  [$clog2(N_BITS/32+1)-1:0] op_idx,   // word to read
+    input  wire                         op_rd_valid,
+    input  wire [$clog2(N_BITS/32+1)-1:0] op_rd_idx,
+    input  wire [31:0]                  op_a_rd,
+    input  wire [31:0]                  op_b_rd,
+
+    output wire                         op_done,    // product / modexp finished
+    output wire [N_BITS-1:0]            y_vec
+);
+
+    localparam integer AXI_NWORDS = N_BITS / 32;
+    localparam integer BIT_W      = $clog2(N_BITS) + 1;
+    localparam integer KI_W       = $clog2(AXI_NWORDS + 1);
+
+    localparam [2:0]
+        OP_ONE_R2  = 3'd0,
+        OP_BASE_R2 = 3'd1,
+        OP_MUL     = 3'd2,
+        OP_SQR     = 3'd3,
+        OP_OUT     = 3'd4,
+        OP_PLAIN   = 3'd5;      // A * B, no modexp
+
+    localparam [2:0]
+        SEQ_IDLE   = 3'd0,
+        SEQ_WAIT   = 3'd1,      // core busy with seq_op
+        SEQ_GAP    = 3'd2,      // start low for a clock, pick the next op
+        SEQ_LOAD   = 3'd3;      // copying A / B and N / R^2 (on a miss)
+
+    // CONTROL.asrc / bsrc
+    localparam [2:0]
+        SRC_MEM    = 3'd0,      // A / B window of the job's bank
+        SRC_RES    = 3'd1,      // result of the previous product
+        SRC_X0     = 3'd2,
+        SRC_X1     = 3'd3,
+        SRC_ONE    = 3'd4,
+        SRC_R2     = 3'd5;      // R^2 mod N of the job's key slot
+
+    // CONTROL.dst
+    localparam [1:0]
+        DST_NONE   = 2'd0,
+        DST_X0     = 2'd1,
+        DST_X1     = 2'd2;
+
+    reg [2:0]         seq_state;
+    reg [2:0]         seq_op;
+    reg [BIT_W-1:0]   seq_bit;
+    reg               seq_start;
+    reg               core_done_d;
+    reg [N_BITS-1:0]  x_reg;        // x, saved register X0
+    reg [N_BITS-1:0]  pow_reg;      // a = base^(2^i) * R mod N, X1
+
+    reg [N_BITS-1:0]  n_res;        // N of res_slot, fed to the core
+    reg [N_BITS-1:0]  r2_res;       // R^2 mod N of res_slot
+    reg [SLOT_W-1:0]  res_slot;
+    reg               res_valid;
+
+    reg [N_BITS-1:0]  a_buf;        // A / B of the job's bank
+    reg [N_BITS-1:0]  b_buf;
+    reg               key_ld;       // SEQ_LOAD: key words still to come
+    reg               op_ld;        // SEQ_LOAD: operand words still to come
+
+    wire              core_done;    // core done, in the clk domain
+    wire              core_idle;    // core has seen start drop: may raise it
+    wire              c_clk;        // core side of the handshake
+    wire              c_rst;
+    wire              c_start;
+    wire              c_done;
+    wire [N_BITS-1:0] core_a;
+    wire [N_BITS-1:0] core_b;
+    wire [N_BITS-1:0] core_n;
+    wire [N_BITS-1:0] len_mask;
+    wire [KI_W-1:0]   len_w = n_len[BIT_W-1:5];
+
+    wire              key_hit = res_valid && (res_slot == slot);
+    wire              op_need = mode_exp || (asrc == SRC_MEM) || (bsrc == SRC_MEM);
+
+    // core done stays high while the core waits in S_DONE; act on its edge
+    wire              core_done_rise = core_done && !core_done_d;
+    wire              seq_step_done  = (seq_state == SEQ_WAIT) && core_done_rise;
+    wire              bit_is_last    = ({{(32-BIT_W){1'b0}}, seq_bit} + 32'd1 >= exp_bits);
+    wire [N_BITS-1:0] one_vec        = {{(N_BITS-1){1'b0}}, 1'b1};
+
+    // -------------------------------------------------------------------------
+    // Core clock: s_axi clock, or core_clk with start / done synchronized
+    // -------------------------------------------------------------------------
+    generate
+        if (CORE_ASYNC != 0) begin : G_CDC
+            (* ASYNC_REG = "TRUE" *) reg [1:0] rst_s;     // core_clk domain
+            (* ASYNC_REG = "TRUE" *) reg [1:0] start_s;
+            (* ASYNC_REG = "TRUE" *) reg [1:0] done_s;    // clk domain
+
+            always @(posedge core_clk) begin
+                rst_s   <= {rst_s[0], ~rstn};
+                start_s <= {start_s[0], seq_start};
+            end
+
+            always @(posedge clk) begin
+                if (!rstn)
+                    done_s <= 2'b00;
+                else
+                    done_s <= {done_s[0], c_done};
+            end
+
+            assign c_clk     = core_clk;
+            assign c_rst     = rst_s[1];
+            assign c_start   = start_s[1];
+            assign core_done = done_s[1];
+            assign core_idle = !done_s[1];
+        end else begin : G_SYNC
+            // one clock with start low returns the core to S_IDLE
+            assign c_clk     = clk;
+            assign c_rst     = ~rstn;
+            assign c_start   = seq_start;
+            assign core_done = c_done;
+            assign core_idle = 1'b1;
+        end
+    endgenerate
+
+    // edge, not level: a queued job may start while core_done is still high
+    assign op_done = seq_step_done && (seq_op == OP_OUT || seq_op == OP_PLAIN);
+    assign e_idx   = seq_bit;
+    assign key_req = (seq_state == SEQ_LOAD) && key_ld;
+    assign op_req  = (seq_state == SEQ_LOAD) && op_ld;
+
+    wire [N_BITS-1:0] plain_a = (asrc == SRC_RES) ? y_vec   :
+                                (asrc == SRC_X0)  ? x_reg   :
+                                (asrc == SRC_X1)  ? pow_reg :
+                                (asrc == SRC_ONE) ? one_vec :
+                                (asrc == SRC_R2)  ? r2_res  : a_buf;
+
+    wire [N_BITS-1:0] plain_b = (bsrc == SRC_RES) ? y_vec   :
+                                (bsrc == SRC_X0)  ? x_reg   :
+                                (bsrc == SRC_X1)  ? pow_reg :
+                                (bsrc == SRC_ONE) ? one_vec :
+                                (bsrc == SRC_R2)  ? r2_res  : b_buf;
+
+    assign core_a = len_mask & ((seq_op == OP_PLAIN)   ? plain_a :
+                                (seq_op == OP_BASE_R2) ? a_buf   :
+                                (seq_op == OP_ONE_R2)  ? one_vec :
+                                (seq_op == OP_SQR)     ? pow_reg : x_reg);
+
+    assign core_b = len_mask & ((seq_op == OP_PLAIN)   ? plain_b :
+                                (seq_op == OP_OUT)     ? one_vec :
+                                (seq_op == OP_ONE_R2 ||
+                                 seq_op == OP_BASE_R2) ? r2_res  : pow_reg);
+
+    assign core_n = len_mask & n_res;
+
+    genvar gw;
+    generate
+        for (gw = 0; gw < AXI_NWORDS; gw = gw + 1) begin : LEN_MASK
+            assign len_mask[32*gw +: 32] = {32{gw < len_w}};
+        end
+    endgenerate
+
+    always @(posedge clk) begin
+        if (!rstn) begin
+            seq_state   <= SEQ_IDLE;
+            seq_op      <= OP_ONE_R2;
+            seq_bit     <= {BIT_W{1'b0}};
+            seq_start   <= 1'b0;
+            core_done_d <= 1'b0;
+            x_reg       <= {N_BITS{1'b0}};
+            pow_reg     <= {N_BITS{1'b0}};
+            n_res       <= {N_BITS{1'b0}};
+            r2_res      <= {N_BITS{1'b0}};
+            res_slot    <= {SLOT_W{1'b0}};
+            res_valid   <= 1'b0;
+            key_idx     <= {KI_W{1'b0}};
+            a_buf       <= {N_BITS{1'b0}};
+            b_buf       <= {N_BITS{1'b0}};
+            key_ld      <= 1'b0;
+            op_ld       <= 1'b0;
+            op_idx      <= {KI_W{1'b0}};
+        end else begin
+            core_done_d <= core_done;
+
+            case (seq_state)
+                SEQ_IDLE: begin
+                    if (go && core_idle) begin
+                        seq_bit    <= {BIT_W{1'b0}};
+                        key_idx    <= {KI_W{1'b0}};
+                        op_idx     <= {KI_W{1'b0}};
+                        if (key_hit && !op_need) begin
+                            seq_op    <= OP_PLAIN;
+                            seq_start <= 1'b1;
+                            seq_state <= SEQ_WAIT;
+                        end else begin
+                            key_ld    <= !key_hit;
+                            op_ld     <= op_need;
+                            seq_state <= SEQ_LOAD;
+                        end
+                    end
+                end
+
+                SEQ_LOAD: begin
+                    if (key_gnt && key_idx < len_w)
+                        key_idx <= key_idx + 1'b1;
+                    if (key_rd_valid) begin
+                        n_res[32*key_rd_idx +: 32]  <= key_n_rd;
+                        r2_res[32*key_rd_idx +: 32] <= key_r2_rd;
+                        if (key_rd_idx == len_w - 1'b1) begin
+                            res_slot  <= slot;
+                            res_valid <= 1'b1;
+                            key_ld    <= 1'b0;
+                        end
+                    end
+                    if (op_gnt && op_idx < len_w)
+                        op_idx <= op_idx + 1'b1;
+                    if (op_rd_valid) begin
+                        a_buf[32*op_rd_idx +: 32] <= op_a_rd;
+                        b_buf[32*op_rd_idx +: 32] <= op_b_rd;
+                        if (op_rd_idx == len_w - 1'b1)
+                            op_ld <= 1'b0;
+                    end
+                    // both copies done (flags seen low from the clock after
+                    // their last word)
+                    if (!key_ld && !op_ld && core_idle) begin
+                        seq_op    <= mode_exp ? OP_ONE_R2 : OP_PLAIN;
+                        seq_start <= 1'b1;
+                        seq_state <= SEQ_WAIT;
+                    end
+                end
+
+                SEQ_WAIT: begin
+                    if (core_done_rise) begin
+                        seq_start <= 1'b0;
+                        case (seq_op)
+                            OP_ONE_R2:  x_reg   <= y_vec;
+                            OP_BASE_R2: pow_reg <= y_vec;
+                            OP_MUL:     x_reg   <= y_vec;
+                            OP_SQR: begin
+                                pow_reg <= y_vec;
+                                seq_bit <= seq_bit + 1'b1;
+                            end
+                            OP_PLAIN: begin
+                                if (dst == DST_X0)
+                                    x_reg   <= y_vec;
+                                else if (dst == DST_X1)
+                                    pow_reg <= y_vec;
+                            end
+                            default: ;
+                        endcase
+                        seq_state <= (seq_op == OP_OUT || seq_op == OP_PLAIN) ?
+                                     SEQ_IDLE : SEQ_GAP;
+                    end
+                end
+
+                SEQ_GAP: begin
+                    // core sees start low this clock and returns to S_IDLE
+                    // (CORE_ASYNC: wait here until it has)
+                    if (core_idle) begin
+                        case (seq_op)
+                            OP_ONE_R2:
+                                seq_op <= OP_BASE_R2;
+                            OP_MUL:
+                                seq_op <= bit_is_last ? OP_OUT : OP_SQR;
+                            default: begin  // OP_BASE_R2, OP_SQR: at bit seq_bit
+                                if (exp_bits == 32'd0)
+                                    seq_op <= OP_OUT;
+                                else if (e_bit)
+                                    seq_op <= OP_MUL;
+                                else
+                                    seq_op <= bit_is_last ? OP_OUT : OP_SQR;
+                            end
+                        endcase
+                        seq_start <= 1'b1;
+                        seq_state <= SEQ_WAIT;
+                    end
+                end
+
+                default: seq_state <= SEQ_IDLE;
+            endcase
+
+            // resident key rewritten (host or DMA): copy it again next time
+            if (key_inval[res_slot])
+                res_valid <= 1'b0;
+        end
+    end
+
+    // -------------------------------------------------------------------------
+    // Core instance
+    // -------------------------------------------------------------------------
+    generate
+        if (CORE_TYPE == 1) begin : G_CORE_1CYC
+            montgomery_mul_1cyc #(
+                .N_BITS (N_BITS)
+            ) u_montgomery_mul (
+                .clk     (c_clk),
+                .rst     (c_rst),
+                .start   (c_start),
+                .a_in    (core_a),
+                .b_in    (core_b),
+                .n_in    (core_n),
+                .n_prime (n_prime),
+                .n_len   (n_len),
+                .result  (y_vec),
+                .done    (c_done),
+                .dbg_state(),
+                .dbg_bit_idx()
+            );
+        end else if (CORE_TYPE == 2) begin : G_CORE_CSA
+            montgomery_mul_csa #(
+                .N_BITS (N_BITS)
+            ) u_montgomery_mul (
+                .clk     (c_clk),
+                .rst     (c_rst),
+                .start   (c_start),
+                .a_in    (core_a),
+                .b_in    (core_b),
+                .n_in    (core_n),
+                .n_prime (n_prime),
+                .n_len   (n_len),
+                .result  (y_vec),
+                .done    (c_done),
+                .dbg_state(),
+                .dbg_bit_idx()
+            );
+        end else if (CORE_TYPE == 3) begin : G_CORE_R4
+            montgomery_mul_r4 #(
+                .N_BITS (N_BITS)
+            ) u_montgomery_mul (
+                .clk     (c_clk),
+                .rst     (c_rst),
+                .start   (c_start),
+                .a_in    (core_a),
+                .b_in    (core_b),
+                .n_in    (core_n),
+                .n_prime (n_prime),
+                .n_len   (n_len),
+                .result  (y_vec),
+                .done    (c_done),
+                .dbg_state(),
+                .dbg_bit_idx()
+            );
+        end else if (CORE_TYPE == 4) begin : G_CORE_WORD
+            montgomery_mul_word #(
+                .N_BITS (N_BITS)
+            ) u_montgomery_mul (
+                .clk     (c_clk),
+                .rst     (c_rst),
+                .start   (c_start),
+                .a_in    (core_a),
+                .b_in    (core_b),
+                .n_in    (core_n),
+                .n_prime (n_prime),
+                .n_len   (n_len),
+                .result  (y_vec),
+                .done    (c_done),
+                .dbg_state(),
+                .dbg_bit_idx()
+            );
+        end else if (CORE_TYPE == 5) begin : G_CORE_SYSTOLIC
+            montgomery_mul_systolic #(
+                .N_BITS (N_BITS),
+                .NUM_PE (NUM_PE)
+            ) u_montgomery_mul (
+                .clk     (c_clk),
+                .rst     (c_rst),
+                .start   (c_start),
+                .a_in    (core_a),
+                .b_in    (core_b),
+                .n_in    (core_n),
+                .n_prime (n_prime),
+                .n_len   (n_len),
+                .result  (y_vec),
+                .done    (c_done),
+                .dbg_state(),
+                .dbg_bit_idx()
+            );
+        end else begin : G_CORE_RADIX2
+            montgomery_mul #(
+                .N_BITS (N_BITS)
+            ) u_montgomery_mul (
+                .clk     (c_clk),
+                .rst     (c_rst),
+                .start   (c_start),
+                .a_in    (core_a),
+                .b_in    (core_b),
+                .n_in    (core_n),
+                .n_prime (n_prime),
+                .n_len   (n_len),
+                .result  (y_vec),
+                .done    (c_done),
+                .dbg_state(),
+                .dbg_bit_idx()
+            );
+        end
+    endgenerate
+
+endmodule
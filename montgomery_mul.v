@@ -3,7 +3,9 @@
 // montgomery_mul.v
 // Radix-2 bit-serial Montgomery modular multiplier
 //
-// Computes: result = A * B * R^{-1} mod N, where R = 2^N_BITS.
+// Computes: result = A * B * R^{-1} mod N, where R = 2^n_len (n_len <= N_BITS,
+// a multiple of 32; operand bits from n_len up must be 0). The bit loop
+// stops after n_len bits, so shorter keys finish sooner.
 //
 // NOTE: This is a *Montgomery* product, not plain (A*B mod N).
 // -----------------------------------------------------------------------------
@@ -18,6 +20,7 @@ module montgomery_mul #(
     input  wire [N_BITS-1:0]       b_in,     // operand B
     input  wire [N_BITS-1:0]       n_in,     // modulus N (odd, N < R)
     input  wire [31:0]             n_prime,  // unused in this radix-2 core
+    input  wire [$clog2(N_BITS):0] n_len,    // modulus length in bits
 
     output reg  [N_BITS-1:0]       result,   // Montgomery product
     output reg                     done,     // 1-cycle pulse when result valid
@@ -40,7 +43,7 @@ module montgomery_mul #(
     reg [2:0]               state, next_state;
 
     // Internals
-    reg [N_BITS:0]          T;       // accumulator (one extra bit)
+    reg [N_BITS+1:0]        T;       // accumulator (T + A < 3N needs two extra bits)
     reg [N_BITS-1:0]        a_reg;
     reg [N_BITS-1:0]        b_reg;
     reg [N_BITS-1:0]        n_reg;
@@ -48,8 +51,8 @@ module montgomery_mul #(
 
     // convenience
     wire                    b_bit = b_reg[bit_idx];
-    wire [N_BITS:0]         a_ext = {1'b0, a_reg};
-    wire [N_BITS:0]         n_ext = {1'b0, n_reg};
+    wire [N_BITS+1:0]       a_ext = {2'b00, a_reg};
+    wire [N_BITS+1:0]       n_ext = {2'b00, n_reg};
 
     // -------------------------------------------------------------------------
     // Sequential logic
@@ -58,7 +61,7 @@ module montgomery_mul #(
         if (rst) begin
             state       <= S_IDLE;
             done        <= 1'b0;
-            T           <= {(N_BITS+1){1'b0}};
+            T           <= {(N_BITS+2){1'b0}};
             a_reg       <= {N_BITS{1'b0}};
             b_reg       <= {N_BITS{1'b0}};
             n_reg       <= {N_BITS{1'b0}};
@@ -81,7 +84,7 @@ module montgomery_mul #(
                     a_reg   <= a_in;
                     b_reg   <= b_in;
                     n_reg   <= n_in;
-                    T       <= {(N_BITS+1){1'b0}};
+                    T       <= {(N_BITS+2){1'b0}};
                     bit_idx <= {($clog2(N_BITS)+1){1'b0}}; // 0
                 end
 
@@ -96,14 +99,14 @@ module montgomery_mul #(
                 end
 
                 S_SHIFT: begin
-                    T       <= {1'b0, T[N_BITS:1]};   // divide by 2
+                    T       <= {1'b0, T[N_BITS+1:1]}; // divide by 2
                     bit_idx <= bit_idx + 1'b1;
                 end
 
                 S_FINAL_SUB: begin
-                    // conditional subtract if T >= N
-                    if (T[N_BITS-1:0] >= n_reg)
-                        T <= {1'b0, T[N_BITS-1:0] - n_reg};
+                    // conditional subtract if T >= N (T < 2N)
+                    if (T >= n_ext)
+                        T <= T - n_ext;
                 end
 
                 S_DONE: begin
@@ -132,7 +135,7 @@ module montgomery_mul #(
             S_ADD_N:     next_state = S_SHIFT;
 
             S_SHIFT: begin
-                if (bit_idx == (N_BITS-1))
+                if (bit_idx == n_len - 1'b1)
                     next_state = S_FINAL_SUB;
                 else
                     next_state = S_ADD_A;
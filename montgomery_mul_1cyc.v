@@ -0,0 +1,157 @@
+`timescale 1ns / 1ps
+// -----------------------------------------------------------------------------
+// montgomery_mul_1cyc.v
+// Radix-2 bit-serial Montgomery modular multiplier, one clock per bit of B
+//
+// Computes: result = A * B * R^{-1} mod N, where R = 2^n_len (n_len <= N_BITS,
+// a multiple of 32; operand bits from n_len up must be 0). The bit loop
+// stops after n_len bits, so shorter keys finish sooner.
+//
+// Same recurrence as montgomery_mul, but the ADD_A / ADD_N / SHIFT steps are
+// merged into a single S_ITER state:
+//     q = (T + b_i*A)[0] = T[0] ^ (b_i & A[0])
+//     T <= (T + b_i*A + q*N) / 2
+// so a product takes N_BITS + 3 cycles instead of 3*N_BITS + 3. The price is
+// two chained (N_BITS+2)-bit additions in one cycle.
+//
+// Drop-in replacement for montgomery_mul (same ports), selected in
+// montgomery_axi with CORE_TYPE = 1.
+// -----------------------------------------------------------------------------
+module montgomery_mul_1cyc #(
+    parameter integer N_BITS = 2048          // must be >= 32, multiple of 32
+)(
+    input  wire                    clk,
+    input  wire                    rst,      // synchronous, active high
+    input  wire                    start,    // 1-cycle pulse
+
+    input  wire [N_BITS-1:0]       a_in,     // operand A
+    input  wire [N_BITS-1:0]       b_in,     // operand B
+    input  wire [N_BITS-1:0]       n_in,     // modulus N (odd, N < R)
+    input  wire [31:0]             n_prime,  // unused in this radix-2 core
+    input  wire [$clog2(N_BITS):0] n_len,    // modulus length in bits
+
+    output reg  [N_BITS-1:0]       result,   // Montgomery product
+    output reg                     done,     // 1-cycle pulse when result valid
+
+    // optional debug outputs
+    output reg  [2:0]              dbg_state,
+    output reg  [$clog2(N_BITS):0] dbg_bit_idx
+);
+
+    // FSM states
+    localparam [2:0]
+        S_IDLE      = 3'd0,
+        S_LOAD      = 3'd1,
+        S_ITER      = 3'd2,
+        S_FINAL_SUB = 3'd5,
+        S_DONE      = 3'd6;
+
+    reg [2:0]               state, next_state;
+
+    // Internals
+    reg [N_BITS+1:0]        T;       // accumulator, T < 2N between iterations
+    reg [N_BITS-1:0]        a_reg;
+    reg [N_BITS-1:0]        b_reg;   // shifted right once per iteration
+    reg [N_BITS-1:0]        n_reg;
+    reg [$clog2(N_BITS):0]  bit_idx;
+
+    // one iteration, combinational
+    wire                    b_bit  = b_reg[0];
+    wire                    q_bit  = T[0] ^ (b_bit & a_reg[0]);
+    wire [N_BITS+1:0]       a_term = b_bit ? {2'b00, a_reg} : {(N_BITS+2){1'b0}};
+    wire [N_BITS+1:0]       n_term = q_bit ? {2'b00, n_reg} : {(N_BITS+2){1'b0}};
+    wire [N_BITS+1:0]       t_sum  = T + a_term + n_term;   // < 4N, even
+
+    wire [N_BITS+1:0]       n_ext  = {2'b00, n_reg};
+
+    // -------------------------------------------------------------------------
+    // Sequential logic
+    // -------------------------------------------------------------------------
+    always @(posedge clk) begin
+        if (rst) begin
+            state       <= S_IDLE;
+            done        <= 1'b0;
+            T           <= {(N_BITS+2){1'b0}};
+            a_reg       <= {N_BITS{1'b0}};
+            b_reg       <= {N_BITS{1'b0}};
+            n_reg       <= {N_BITS{1'b0}};
+            bit_idx     <= {($clog2(N_BITS)+1){1'b0}};
+            result      <= {N_BITS{1'b0}};
+            dbg_state   <= S_IDLE;
+            dbg_bit_idx <= {($clog2(N_BITS)+1){1'b0}};
+        end else begin
+            state       <= next_state;
+            done        <= 1'b0;        // default: only assert in S_DONE
+            dbg_state   <= next_state;
+            dbg_bit_idx <= bit_idx;
+
+            case (state)
+                S_IDLE: begin
+                    // wait for start, nothing to do
+                end
+
+                S_LOAD: begin
+                    a_reg   <= a_in;
+                    b_reg   <= b_in;
+                    n_reg   <= n_in;
+                    T       <= {(N_BITS+2){1'b0}};
+                    bit_idx <= {($clog2(N_BITS)+1){1'b0}}; // 0
+                end
+
+                S_ITER: begin
+                    T       <= {1'b0, t_sum[N_BITS+1:1]};   // divide by 2
+                    b_reg   <= {1'b0, b_reg[N_BITS-1:1]};
+                    bit_idx <= bit_idx + 1'b1;
+                end
+
+                S_FINAL_SUB: begin
+                    // T < 2N: one conditional subtract
+                    if (T >= n_ext)
+                        T <= T - n_ext;
+                end
+
+                S_DONE: begin
+                    result <= T[N_BITS-1:0];
+                    done   <= 1'b1;   // 1-cycle pulse
+                end
+
+                default: ;
+            endcase
+        end
+    end
+
+    // -------------------------------------------------------------------------
+    // Next-state logic
+    // -------------------------------------------------------------------------
+    always @(*) begin
+        next_state = state;
+        case (state)
+            S_IDLE: begin
+                if (start)
+                    next_state = S_LOAD;
+            end
+
+            S_LOAD:      next_state = S_ITER;
+
+            S_ITER: begin
+                if (bit_idx == n_len - 1'b1)
+                    next_state = S_FINAL_SUB;
+                else
+                    next_state = S_ITER;
+            end
+
+            S_FINAL_SUB: next_state = S_DONE;
+
+            S_DONE: begin
+                // wait for start to drop before going back to IDLE
+                if (!start)
+                    next_state = S_IDLE;
+                else
+                    next_state = S_DONE;
+            end
+
+            default:      next_state = S_IDLE;
+        endcase
+    end
+
+endmodule
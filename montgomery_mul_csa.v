@@ -0,0 +1,216 @@
+`timescale 1ns / 1ps
+// -----------------------------------------------------------------------------
+// montgomery_mul_csa.v
+// Radix-2 Montgomery modular multiplier with a carry-save accumulator
+//
+// Computes: result = A * B * R^{-1} mod N, where R = 2^n_len (n_len <= N_BITS,
+// a multiple of 32; operand bits from n_len up must be 0). The bit loop
+// stops after n_len bits, so shorter keys finish sooner.
+//
+// T is kept as two vectors, T = S + C, so each bit iteration is two levels
+// of 3:2 compressors (no carry propagation at all):
+//     (S1, C1) = CSA(S, C, b_i*A)
+//     q        = S1[0]                 (C1[0] is always 0)
+//     (S2, C2) = CSA(S1, C1, q*N)
+//     S, C    <= S2 / 2, C2 / 2
+// After the last bit, S_RESOLVE adds S + C and subtracts N in RES_W-bit
+// chunks (one chunk per clock, carry/borrow kept in flops), so the longest
+// carry chain in the core is RES_W bits wide. S_FINAL_SUB then picks T or
+// T - N from the final borrow.
+//
+// Latency: n_len + ceil((N_BITS+2)/RES_W) + 3 clocks.
+//
+// Drop-in replacement for montgomery_mul (same ports), selected in
+// montgomery_axi with CORE_TYPE = 2.
+// -----------------------------------------------------------------------------
+module montgomery_mul_csa #(
+    parameter integer N_BITS = 2048,         // must be >= 32, multiple of 32
+    parameter integer RES_W  = 64            // carry-propagate chunk width, < N_BITS
+)(
+    input  wire                    clk,
+    input  wire                    rst,      // synchronous, active high
+    input  wire                    start,    // 1-cycle pulse
+
+    input  wire [N_BITS-1:0]       a_in,     // operand A
+    input  wire [N_BITS-1:0]       b_in,     // operand B
+    input  wire [N_BITS-1:0]       n_in,     // modulus N (odd, N < R)
+    input  wire [31:0]             n_prime,  // unused in this radix-2 core
+    input  wire [$clog2(N_BITS):0] n_len,    // modulus length in bits
+
+    output reg  [N_BITS-1:0]       result,   // Montgomery product
+    output reg                     done,     // 1-cycle pulse when result valid
+
+    // optional debug outputs
+    output reg  [2:0]              dbg_state,
+    output reg  [$clog2(N_BITS):0] dbg_bit_idx
+);
+
+    // FSM states
+    localparam [2:0]
+        S_IDLE      = 3'd0,
+        S_LOAD      = 3'd1,
+        S_ITER      = 3'd2,
+        S_RESOLVE   = 3'd3,
+        S_FINAL_SUB = 3'd5,
+        S_DONE      = 3'd6;
+
+    // carry-save width (T + A + N < 4N) and chunked resolve width
+    localparam integer W         = N_BITS + 2;
+    localparam integer RES_STEPS = (W + RES_W - 1) / RES_W;
+    localparam integer PAD       = RES_STEPS * RES_W;
+
+    reg [2:0]               state, next_state;
+
+    // Internals
+    reg [PAD-1:0]           S;       // sum vector   (bits >= W stay 0 in S_ITER)
+    reg [PAD-1:0]           C;       // carry vector
+    reg [N_BITS-1:0]        a_reg;
+    reg [N_BITS-1:0]        b_reg;   // shifted right once per iteration
+    reg [PAD-1:0]           n_reg;   // shifted right by RES_W in S_RESOLVE
+    reg [$clog2(N_BITS):0]  bit_idx;
+
+    reg [PAD-1:0]           t_acc;   // resolved T       (filled from the top)
+    reg [PAD-1:0]           d_acc;   // resolved T - N
+    reg                     res_carry;
+    reg                     res_borrow;
+    reg [$clog2(RES_STEPS+1):0] res_idx;
+
+    // one iteration, carry-save
+    wire                    b_bit = b_reg[0];
+    wire [W-1:0]            s0    = S[W-1:0];
+    wire [W-1:0]            c0    = C[W-1:0];
+    wire [W-1:0]            x1    = b_bit ? {2'b00, a_reg} : {W{1'b0}};
+    wire [W-1:0]            s1    = s0 ^ c0 ^ x1;
+    wire [W-1:0]            m1    = (s0 & c0) | (s0 & x1) | (c0 & x1);
+    wire [W-1:0]            c1    = {m1[W-2:0], 1'b0};
+    wire                    q_bit = s1[0];
+    wire [W-1:0]            x2    = q_bit ? {2'b00, n_reg[N_BITS-1:0]} : {W{1'b0}};
+    wire [W-1:0]            s2    = s1 ^ c1 ^ x2;                 // s2[0] == 0
+    wire [W-1:0]            m2    = (s1 & c1) | (s1 & x2) | (c1 & x2);
+
+    // one resolve chunk: T_k = S_k + C_k + cy,  D_k = T_k - N_k - bw
+    wire [RES_W:0]          t_chunk = {1'b0, S[RES_W-1:0]} + {1'b0, C[RES_W-1:0]}
+                                      + {{RES_W{1'b0}}, res_carry};
+    wire [RES_W:0]          d_chunk = {1'b0, t_chunk[RES_W-1:0]} - {1'b0, n_reg[RES_W-1:0]}
+                                      - {{RES_W{1'b0}}, res_borrow};
+
+    // -------------------------------------------------------------------------
+    // Sequential logic
+    // -------------------------------------------------------------------------
+    always @(posedge clk) begin
+        if (rst) begin
+            state       <= S_IDLE;
+            done        <= 1'b0;
+            S           <= {PAD{1'b0}};
+            C           <= {PAD{1'b0}};
+            a_reg       <= {N_BITS{1'b0}};
+            b_reg       <= {N_BITS{1'b0}};
+            n_reg       <= {PAD{1'b0}};
+            bit_idx     <= {($clog2(N_BITS)+1){1'b0}};
+            t_acc       <= {PAD{1'b0}};
+            d_acc       <= {PAD{1'b0}};
+            res_carry   <= 1'b0;
+            res_borrow  <= 1'b0;
+            res_idx     <= {($clog2(RES_STEPS+1)+1){1'b0}};
+            result      <= {N_BITS{1'b0}};
+            dbg_state   <= S_IDLE;
+            dbg_bit_idx <= {($clog2(N_BITS)+1){1'b0}};
+        end else begin
+            state       <= next_state;
+            done        <= 1'b0;        // default: only assert in S_DONE
+            dbg_state   <= next_state;
+            dbg_bit_idx <= bit_idx;
+
+            case (state)
+                S_IDLE: begin
+                    // wait for start, nothing to do
+                end
+
+                S_LOAD: begin
+                    a_reg      <= a_in;
+                    b_reg      <= b_in;
+                    n_reg      <= {{(PAD-N_BITS){1'b0}}, n_in};
+                    S          <= {PAD{1'b0}};
+                    C          <= {PAD{1'b0}};
+                    bit_idx    <= {($clog2(N_BITS)+1){1'b0}}; // 0
+                    res_carry  <= 1'b0;
+                    res_borrow <= 1'b0;
+                    res_idx    <= {($clog2(RES_STEPS+1)+1){1'b0}};
+                end
+
+                S_ITER: begin
+                    S[W-1:0] <= {1'b0, s2[W-1:1]};             // divide by 2
+                    C[W-1:0] <= {1'b0, m2[W-2:0]};             // (m2 << 1) / 2
+                    b_reg    <= {1'b0, b_reg[N_BITS-1:1]};
+                    bit_idx  <= bit_idx + 1'b1;
+                end
+
+                S_RESOLVE: begin
+                    t_acc      <= {t_chunk[RES_W-1:0], t_acc[PAD-1:RES_W]};
+                    d_acc      <= {d_chunk[RES_W-1:0], d_acc[PAD-1:RES_W]};
+                    res_carry  <= t_chunk[RES_W];
+                    res_borrow <= d_chunk[RES_W];
+                    S          <= {{RES_W{1'b0}}, S[PAD-1:RES_W]};
+                    C          <= {{RES_W{1'b0}}, C[PAD-1:RES_W]};
+                    n_reg      <= {{RES_W{1'b0}}, n_reg[PAD-1:RES_W]};
+                    res_idx    <= res_idx + 1'b1;
+                end
+
+                S_FINAL_SUB: begin
+                    // no borrow out of T - N means T >= N
+                    if (!res_borrow)
+                        t_acc <= d_acc;
+                end
+
+                S_DONE: begin
+                    result <= t_acc[N_BITS-1:0];
+                    done   <= 1'b1;   // 1-cycle pulse
+                end
+
+                default: ;
+            endcase
+        end
+    end
+
+    // -------------------------------------------------------------------------
+    // Next-state logic
+    // -------------------------------------------------------------------------
+    always @(*) begin
+        next_state = state;
+        case (state)
+            S_IDLE: begin
+                if (start)
+                    next_state = S_LOAD;
+            end
+
+            S_LOAD:      next_state = S_ITER;
+
+            S_ITER: begin
+                if (bit_idx == n_len - 1'b1)
+                    next_state = S_RESOLVE;
+                else
+                    next_state = S_ITER;
+            end
+
+            S_RESOLVE: begin
+                if (res_idx == (RES_STEPS-1))
+                    next_state = S_FINAL_SUB;
+                else
+                    next_state = S_RESOLVE;
+            end
+
+            S_FINAL_SUB: next_state = S_DONE;
+
+            S_DONE: begin
+                // wait for start to drop before going back to IDLE
+                if (!start)
+                    next_state = S_IDLE;
+                else
+                    next_state = S_DONE;
+            end
+
+            default:      next_state = S_IDLE;
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,197 @@
+`timescale 1ns / 1ps
+// -----------------------------------------------------------------------------
+// montgomery_mul_r4.v
+// Radix-4 Montgomery modular multiplier (two bits of B per clock)
+//
+// Computes: result = A * B * R^{-1} mod N, where R = 2^n_len (n_len <= N_BITS,
+// a multiple of 32; operand bits from n_len up must be 0). The bit loop
+// stops after n_len bits, so shorter keys finish sooner.
+//
+// Per iteration, with d = {b_{2i+1}, b_{2i}} and n4' = -N^{-1} mod 4
+// (3 when N mod 4 == 1, 1 when N mod 4 == 3):
+//     U = T + d*A                      d*A from {0, A, 2A, 3A}
+//     q = (U mod 4) * n4' mod 4
+//     T <= (U + q*N) / 4               q*N from {0, N, 2N, 3N}
+// T stays < 2N, so one conditional subtract finishes the product.
+// 3A and 3N are formed once in S_PRECOMP.
+//
+// Latency: n_len/2 + 4 clocks.
+//
+// Drop-in replacement for montgomery_mul (same ports), selected in
+// montgomery_axi with CORE_TYPE = 3.
+// -----------------------------------------------------------------------------
+module montgomery_mul_r4 #(
+    parameter integer N_BITS = 2048          // must be >= 32, multiple of 32
+)(
+    input  wire                    clk,
+    input  wire                    rst,      // synchronous, active high
+    input  wire                    start,    // 1-cycle pulse
+
+    input  wire [N_BITS-1:0]       a_in,     // operand A
+    input  wire [N_BITS-1:0]       b_in,     // operand B
+    input  wire [N_BITS-1:0]       n_in,     // modulus N (odd, N < R)
+    input  wire [31:0]             n_prime,  // unused (n4' comes from N[1])
+    input  wire [$clog2(N_BITS):0] n_len,    // modulus length in bits
+
+    output reg  [N_BITS-1:0]       result,   // Montgomery product
+    output reg                     done,     // 1-cycle pulse when result valid
+
+    // optional debug outputs
+    output reg  [2:0]              dbg_state,
+    output reg  [$clog2(N_BITS):0] dbg_bit_idx
+);
+
+    // FSM states
+    localparam [2:0]
+        S_IDLE      = 3'd0,
+        S_LOAD      = 3'd1,
+        S_ITER      = 3'd2,
+        S_PRECOMP   = 3'd4,
+        S_FINAL_SUB = 3'd5,
+        S_DONE      = 3'd6;
+
+    // T + 3A + 3N < 8N
+    localparam integer W = N_BITS + 3;
+
+    reg [2:0]               state, next_state;
+
+    // Internals
+    reg [W-1:0]             T;
+    reg [N_BITS-1:0]        a_reg;
+    reg [N_BITS+1:0]        a3_reg;  // 3A
+    reg [N_BITS-1:0]        b_reg;   // shifted right by 2 per iteration
+    reg [N_BITS-1:0]        n_reg;
+    reg [N_BITS+1:0]        n3_reg;  // 3N
+    reg [$clog2(N_BITS):0]  bit_idx;
+
+    // one radix-4 iteration, combinational
+    wire [1:0]              b_dig  = b_reg[1:0];
+    wire [1:0]              n4p    = n_reg[1] ? 2'd1 : 2'd3;
+
+    reg  [W-1:0]            a_term;
+    reg  [W-1:0]            n_term;
+
+    always @(*) begin
+        case (b_dig)
+            2'd0:    a_term = {W{1'b0}};
+            2'd1:    a_term = {3'b000, a_reg};
+            2'd2:    a_term = {2'b00, a_reg, 1'b0};
+            default: a_term = {1'b0, a3_reg};
+        endcase
+    end
+
+    wire [1:0]              u_low  = T[1:0] + a_term[1:0];
+    wire [3:0]              q_mul  = u_low * n4p;
+    wire [1:0]              q_dig  = q_mul[1:0];
+
+    always @(*) begin
+        case (q_dig)
+            2'd0:    n_term = {W{1'b0}};
+            2'd1:    n_term = {3'b000, n_reg};
+            2'd2:    n_term = {2'b00, n_reg, 1'b0};
+            default: n_term = {1'b0, n3_reg};
+        endcase
+    end
+
+    wire [W-1:0]            t_sum  = T + a_term + n_term;    // divisible by 4
+    wire [W-1:0]            n_ext  = {3'b000, n_reg};
+
+    // -------------------------------------------------------------------------
+    // Sequential logic
+    // -------------------------------------------------------------------------
+    always @(posedge clk) begin
+        if (rst) begin
+            state       <= S_IDLE;
+            done        <= 1'b0;
+            T           <= {W{1'b0}};
+            a_reg       <= {N_BITS{1'b0}};
+            a3_reg      <= {(N_BITS+2){1'b0}};
+            b_reg       <= {N_BITS{1'b0}};
+            n_reg       <= {N_BITS{1'b0}};
+            n3_reg      <= {(N_BITS+2){1'b0}};
+            bit_idx     <= {($clog2(N_BITS)+1){1'b0}};
+            result      <= {N_BITS{1'b0}};
+            dbg_state   <= S_IDLE;
+            dbg_bit_idx <= {($clog2(N_BITS)+1){1'b0}};
+        end else begin
+            state       <= next_state;
+            done        <= 1'b0;        // default: only assert in S_DONE
+            dbg_state   <= next_state;
+            dbg_bit_idx <= bit_idx;
+
+            case (state)
+                S_IDLE: begin
+                    // wait for start, nothing to do
+                end
+
+                S_LOAD: begin
+                    a_reg   <= a_in;
+                    b_reg   <= b_in;
+                    n_reg   <= n_in;
+                    T       <= {W{1'b0}};
+                    bit_idx <= {($clog2(N_BITS)+1){1'b0}}; // 0
+                end
+
+                S_PRECOMP: begin
+                    a3_reg  <= {2'b00, a_reg} + {1'b0, a_reg, 1'b0};
+                    n3_reg  <= {2'b00, n_reg} + {1'b0, n_reg, 1'b0};
+                end
+
+                S_ITER: begin
+                    T       <= {2'b00, t_sum[W-1:2]};        // divide by 4
+                    b_reg   <= {2'b00, b_reg[N_BITS-1:2]};
+                    bit_idx <= bit_idx + 2'd2;
+                end
+
+                S_FINAL_SUB: begin
+                    // T < 2N: one conditional subtract
+                    if (T >= n_ext)
+                        T <= T - n_ext;
+                end
+
+                S_DONE: begin
+                    result <= T[N_BITS-1:0];
+                    done   <= 1'b1;   // 1-cycle pulse
+                end
+
+                default: ;
+            endcase
+        end
+    end
+
+    // -------------------------------------------------------------------------
+    // Next-state logic
+    // -------------------------------------------------------------------------
+    always @(*) begin
+        next_state = state;
+        case (state)
+            S_IDLE: begin
+                if (start)
+                    next_state = S_LOAD;
+            end
+
+            S_LOAD:      next_state = S_PRECOMP;
+            S_PRECOMP:   next_state = S_ITER;
+
+            S_ITER: begin
+                if (bit_idx == n_len - 2'd2)
+                    next_state = S_FINAL_SUB;
+                else
+                    next_state = S_ITER;
+            end
+
+            S_FINAL_SUB: next_state = S_DONE;
+
+            S_DONE: begin
+                // wait for start to drop before going back to IDLE
+                if (!start)
+                    next_state = S_IDLE;
+                else
+                    next_state = S_DONE;
+            end
+
+            default:      next_state = S_IDLE;
+        endcase
+    end
+
+endmodule
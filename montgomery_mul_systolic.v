@@ -0,0 +1,362 @@
+`timescale 1ns / 1ps
+// -----------------------------------------------------------------------------
+// montgomery_mul_systolic.v
+// Scalable Montgomery multiplier: Tenca-Koc multiple-word radix-2 (MWR2MM)
+// systolic array with NUM_PE processing elements
+//
+// Computes: result = A * B * R^{-1} mod N, where R = 2^n_len.
+//
+// S, A and N are split into E = ceil((n_len+2)/WORD_W) words. The feeder
+// streams the E words of (S, A, N) into PE 0 once per pass; PE k handles
+// bit (pass*NUM_PE + k) of B and hands its output stream to PE k+1 two
+// clocks later. The stream leaving the last PE goes into a feedback FIFO and
+// becomes S for the next pass; after n_len/NUM_PE passes it is collected
+// word by word together with T - N, and S_FINAL_SUB picks the result.
+//
+// n_len is N_BITS or, when N_BITS is a multiple of 512, WORD_W is 32 and
+// NUM_PE divides 512, any multiple of 512 below it (operand bits from n_len
+// up must be 0). A and N then rotate within their low E words.
+//
+// A pass occupies PE 0 for max(E, 2*NUM_PE + 2) clocks, so latency is about
+//     (n_len/NUM_PE) * max(E, 2*NUM_PE + 2) + 2*NUM_PE + E
+// and stops improving once 2*NUM_PE + 2 > E. Area grows linearly with
+// NUM_PE (one WORD_W-bit 3-input adder and ~5*WORD_W flip-flops per PE),
+// independent of N_BITS.
+//
+// Drop-in replacement for montgomery_mul (same ports), selected in
+// montgomery_axi with CORE_TYPE = 5.
+// -----------------------------------------------------------------------------
+module montgomery_mul_systolic #(
+    parameter integer N_BITS = 2048,         // must be >= 32, multiple of 32
+    parameter integer NUM_PE = 16,           // must divide N_BITS
+    parameter integer WORD_W = 32
+)(
+    input  wire                    clk,
+    input  wire                    rst,      // synchronous, active high
+    input  wire                    start,    // 1-cycle pulse
+
+    input  wire [N_BITS-1:0]       a_in,     // operand A
+    input  wire [N_BITS-1:0]       b_in,     // operand B
+    input  wire [N_BITS-1:0]       n_in,     // modulus N (odd, N < R)
+    input  wire [31:0]             n_prime,  // unused in this radix-2 core
+    input  wire [$clog2(N_BITS):0] n_len,    // modulus length in bits
+
+    output reg  [N_BITS-1:0]       result,   // Montgomery product
+    output reg                     done,     // 1-cycle pulse when result valid
+
+    // optional debug outputs
+    output reg  [2:0]              dbg_state,
+    output reg  [$clog2(N_BITS):0] dbg_bit_idx
+);
+
+    // FSM states
+    localparam [2:0]
+        S_IDLE      = 3'd0,
+        S_LOAD      = 3'd1,
+        S_RUN       = 3'd2,
+        S_FINAL_SUB = 3'd5,
+        S_DONE      = 3'd6;
+
+    localparam integer E      = (N_BITS + 2 + WORD_W - 1) / WORD_W;
+    localparam integer PAD    = E * WORD_W;
+    localparam integer PASSES = N_BITS / NUM_PE;
+    localparam integer EW     = $clog2(E + 1);
+    localparam integer PW     = $clog2(PASSES + 1);
+    localparam integer STEP   = 16;          // n_len granularity, words
+    localparam integer VARLEN = (WORD_W == 32) && (N_BITS % (32*STEP) == 0) &&
+                                ((32*STEP) % NUM_PE == 0);
+
+    reg [2:0]               state, next_state;
+
+    // operands (A and N rotate one word per fed word, back in place after E)
+    reg [PAD-1:0]           a_reg;
+    reg [N_BITS-1:0]        b_reg;   // shifted right by NUM_PE per pass
+    reg [PAD-1:0]           n_reg;
+    reg [PAD-1:0]           n_sub;   // N for the final subtract, shifted
+
+    // words per pass and passes for this n_len
+    wire [EW-1:0]           e_len      = VARLEN ? n_len[$clog2(N_BITS):5] + 1'b1 : E;
+    wire [PW-1:0]           passes_len = VARLEN ? n_len / NUM_PE : PASSES;
+
+    // -------------------------------------------------------------------------
+    // Feeder -> PE 0
+    // -------------------------------------------------------------------------
+    reg                     feed_active;
+    reg [EW-1:0]            feed_idx;
+    reg [PW-1:0]            feed_pass;
+
+    reg                     pe0_valid, pe0_first, pe0_last;
+    reg [WORD_W-1:0]        pe0_s, pe0_y, pe0_m;
+    reg [NUM_PE-1:0]        pe0_xv;
+
+    // -------------------------------------------------------------------------
+    // Feedback FIFO (last PE -> feeder), E words deep, no reset (LUTRAM)
+    // -------------------------------------------------------------------------
+    reg [WORD_W-1:0]        fifo_mem [0:E-1];
+    reg [EW-1:0]            fifo_wr, fifo_rd;
+    reg [EW:0]              fifo_count;
+
+    // -------------------------------------------------------------------------
+    // PE chain
+    // -------------------------------------------------------------------------
+    wire                    ch_valid [0:NUM_PE];
+    wire                    ch_first [0:NUM_PE];
+    wire                    ch_last  [0:NUM_PE];
+    wire [WORD_W-1:0]       ch_s     [0:NUM_PE];
+    wire [WORD_W-1:0]       ch_y     [0:NUM_PE];
+    wire [WORD_W-1:0]       ch_m     [0:NUM_PE];
+    wire [NUM_PE-1:0]       ch_xv    [0:NUM_PE];
+
+    assign ch_valid[0] = pe0_valid;
+    assign ch_first[0] = pe0_first;
+    assign ch_last[0]  = pe0_last;
+    assign ch_s[0]     = pe0_s;
+    assign ch_y[0]     = pe0_y;
+    assign ch_m[0]     = pe0_m;
+    assign ch_xv[0]    = pe0_xv;
+
+    genvar gp;
+    generate
+        for (gp = 0; gp < NUM_PE; gp = gp + 1) begin : PE
+            montgomery_mul_systolic_pe #(
+                .WORD_W (WORD_W),
+                .XV_W   (NUM_PE)
+            ) u_pe (
+                .clk       (clk),
+                .rst       (rst),
+                .in_valid  (ch_valid[gp]),
+                .in_first  (ch_first[gp]),
+                .in_last   (ch_last[gp]),
+                .in_s      (ch_s[gp]),
+                .in_y      (ch_y[gp]),
+                .in_m      (ch_m[gp]),
+                .in_xv     (ch_xv[gp]),
+                .out_valid (ch_valid[gp+1]),
+                .out_first (ch_first[gp+1]),
+                .out_last  (ch_last[gp+1]),
+                .out_s     (ch_s[gp+1]),
+                .out_y     (ch_y[gp+1]),
+                .out_m     (ch_m[gp+1]),
+                .out_xv    (ch_xv[gp+1])
+            );
+        end
+    endgenerate
+
+    wire                    tail_valid = ch_valid[NUM_PE];
+    wire                    tail_last  = ch_last[NUM_PE];
+    wire [WORD_W-1:0]       tail_s     = ch_s[NUM_PE];
+
+    // -------------------------------------------------------------------------
+    // Collector (last pass only): T and T - N, one word per clock
+    // -------------------------------------------------------------------------
+    reg [PW-1:0]            tail_pass;
+    reg [PAD-1:0]           t_acc;
+    reg [PAD-1:0]           d_acc;
+    reg                     sub_borrow;
+
+    wire                    tail_final = (tail_pass == passes_len - 1'b1);
+    wire [WORD_W:0]         d_word     = {1'b0, tail_s} - {1'b0, n_sub[WORD_W-1:0]}
+                                         - {{WORD_W{1'b0}}, sub_borrow};
+
+    wire                    fifo_push  = (state == S_RUN) && tail_valid && !tail_final;
+    wire                    feed_start = (state == S_RUN) && !feed_active &&
+                                         (feed_pass != passes_len) &&
+                                         ((feed_pass == 0) || (fifo_count != 0));
+    wire                    feed_word  = feed_active || feed_start;
+    wire                    fifo_pop   = feed_word && (feed_pass != 0);
+
+    // -------------------------------------------------------------------------
+    // A and N rotate within their low e_len words; T and T - N are filled from
+    // word e_len-1 down. Only ring tops other than E-1 need a second input.
+    // -------------------------------------------------------------------------
+    wire [PAD-1:0]          a_rot, n_rot, t_fill, d_fill;
+    wire [N_BITS-1:0]       len_mask;
+
+    genvar gw;
+    generate
+        for (gw = 0; gw < E; gw = gw + 1) begin : ROT
+            if (gw == E - 1) begin : G_TOP
+                assign a_rot[WORD_W*gw +: WORD_W]  = a_reg[WORD_W-1:0];
+                assign n_rot[WORD_W*gw +: WORD_W]  = n_reg[WORD_W-1:0];
+                assign t_fill[WORD_W*gw +: WORD_W] = tail_s;
+                assign d_fill[WORD_W*gw +: WORD_W] = d_word[WORD_W-1:0];
+            end else if (VARLEN && gw % STEP == 0 && gw > 0) begin : G_WRAP
+                // top word of the ring for n_len = 32*gw
+                wire top = (e_len == gw + 1);
+                assign a_rot[WORD_W*gw +: WORD_W]  = top ? a_reg[WORD_W-1:0] : a_reg[WORD_W*(gw+1) +: WORD_W];
+                assign n_rot[WORD_W*gw +: WORD_W]  = top ? n_reg[WORD_W-1:0] : n_reg[WORD_W*(gw+1) +: WORD_W];
+                assign t_fill[WORD_W*gw +: WORD_W] = top ? tail_s : t_acc[WORD_W*(gw+1) +: WORD_W];
+                assign d_fill[WORD_W*gw +: WORD_W] = top ? d_word[WORD_W-1:0] : d_acc[WORD_W*(gw+1) +: WORD_W];
+            end else begin : G_SHIFT
+                assign a_rot[WORD_W*gw +: WORD_W]  = a_reg[WORD_W*(gw+1) +: WORD_W];
+                assign n_rot[WORD_W*gw +: WORD_W]  = n_reg[WORD_W*(gw+1) +: WORD_W];
+                assign t_fill[WORD_W*gw +: WORD_W] = t_acc[WORD_W*(gw+1) +: WORD_W];
+                assign d_fill[WORD_W*gw +: WORD_W] = d_acc[WORD_W*(gw+1) +: WORD_W];
+            end
+        end
+
+        if (VARLEN) begin : G_MASK
+            for (gw = 0; gw < N_BITS / 32; gw = gw + 1) begin : W
+                assign len_mask[32*gw +: 32] = {32{gw < e_len - 1'b1}};
+            end
+        end else begin : G_NOMASK
+            assign len_mask = {N_BITS{1'b1}};
+        end
+    endgenerate
+
+    // -------------------------------------------------------------------------
+    // Sequential logic
+    // -------------------------------------------------------------------------
+    always @(posedge clk) begin
+        if (rst) begin
+            state       <= S_IDLE;
+            done        <= 1'b0;
+            a_reg       <= {PAD{1'b0}};
+            b_reg       <= {N_BITS{1'b0}};
+            n_reg       <= {PAD{1'b0}};
+            n_sub       <= {PAD{1'b0}};
+            feed_active <= 1'b0;
+            feed_idx    <= {EW{1'b0}};
+            feed_pass   <= {PW{1'b0}};
+            pe0_valid   <= 1'b0;
+            pe0_first   <= 1'b0;
+            pe0_last    <= 1'b0;
+            pe0_s       <= {WORD_W{1'b0}};
+            pe0_y       <= {WORD_W{1'b0}};
+            pe0_m       <= {WORD_W{1'b0}};
+            pe0_xv      <= {NUM_PE{1'b0}};
+            fifo_wr     <= {EW{1'b0}};
+            fifo_rd     <= {EW{1'b0}};
+            fifo_count  <= {(EW+1){1'b0}};
+            tail_pass   <= {PW{1'b0}};
+            t_acc       <= {PAD{1'b0}};
+            d_acc       <= {PAD{1'b0}};
+            sub_borrow  <= 1'b0;
+            result      <= {N_BITS{1'b0}};
+            dbg_state   <= S_IDLE;
+            dbg_bit_idx <= {($clog2(N_BITS)+1){1'b0}};
+        end else begin
+            state       <= next_state;
+            done        <= 1'b0;        // default: only assert in S_DONE
+            dbg_state   <= next_state;
+            dbg_bit_idx <= feed_pass * NUM_PE;
+            pe0_valid   <= 1'b0;
+
+            case (state)
+                S_IDLE: begin
+                    // wait for start, nothing to do
+                end
+
+                S_LOAD: begin
+                    a_reg       <= {{(PAD-N_BITS){1'b0}}, a_in};
+                    b_reg       <= b_in;
+                    n_reg       <= {{(PAD-N_BITS){1'b0}}, n_in};
+                    n_sub       <= {{(PAD-N_BITS){1'b0}}, n_in};
+                    feed_active <= 1'b0;
+                    feed_idx    <= {EW{1'b0}};
+                    feed_pass   <= {PW{1'b0}};
+                    fifo_wr     <= {EW{1'b0}};
+                    fifo_rd     <= {EW{1'b0}};
+                    fifo_count  <= {(EW+1){1'b0}};
+                    tail_pass   <= {PW{1'b0}};
+                    sub_borrow  <= 1'b0;
+                end
+
+                S_RUN: begin
+                    // ---- feeder: one word of (S, A, N) per clock into PE 0
+                    if (feed_word) begin
+                        pe0_valid <= 1'b1;
+                        pe0_first <= (feed_idx == 0);
+                        pe0_last  <= (feed_idx == e_len - 1'b1);
+                        pe0_s     <= (feed_pass == 0) ? {WORD_W{1'b0}} : fifo_mem[fifo_rd];
+                        pe0_y     <= a_reg[WORD_W-1:0];
+                        pe0_m     <= n_reg[WORD_W-1:0];
+                        pe0_xv    <= b_reg[NUM_PE-1:0];
+                        a_reg     <= a_rot;
+                        n_reg     <= n_rot;
+
+                        if (feed_idx == e_len - 1'b1) begin
+                            feed_active <= 1'b0;
+                            feed_idx    <= {EW{1'b0}};
+                            feed_pass   <= feed_pass + 1'b1;
+                            b_reg       <= b_reg >> NUM_PE;
+                        end else begin
+                            feed_active <= 1'b1;
+                            feed_idx    <= feed_idx + 1'b1;
+                        end
+                    end
+
+                    // ---- feedback FIFO
+                    if (fifo_pop)
+                        fifo_rd <= (fifo_rd == E-1) ? {EW{1'b0}} : fifo_rd + 1'b1;
+                    if (fifo_push) begin
+                        fifo_mem[fifo_wr] <= tail_s;
+                        fifo_wr <= (fifo_wr == E-1) ? {EW{1'b0}} : fifo_wr + 1'b1;
+                    end
+                    if (fifo_push && !fifo_pop)
+                        fifo_count <= fifo_count + 1'b1;
+                    else if (fifo_pop && !fifo_push)
+                        fifo_count <= fifo_count - 1'b1;
+
+                    // ---- collector
+                    if (tail_valid) begin
+                        if (tail_last)
+                            tail_pass <= tail_pass + 1'b1;
+                        if (tail_final) begin
+                            t_acc      <= t_fill;
+                            d_acc      <= d_fill;
+                            sub_borrow <= d_word[WORD_W];
+                            n_sub      <= {{WORD_W{1'b0}}, n_sub[PAD-1:WORD_W]};
+                        end
+                    end
+                end
+
+                S_FINAL_SUB: begin
+                    // no borrow out of T - N means T >= N
+                    if (!sub_borrow)
+                        t_acc <= d_acc;
+                end
+
+                S_DONE: begin
+                    result <= t_acc[N_BITS-1:0] & len_mask;
+                    done   <= 1'b1;   // 1-cycle pulse
+                end
+
+                default: ;
+            endcase
+        end
+    end
+
+    // -------------------------------------------------------------------------
+    // Next-state logic
+    // -------------------------------------------------------------------------
+    always @(*) begin
+        next_state = state;
+        case (state)
+            S_IDLE: begin
+                if (start)
+                    next_state = S_LOAD;
+            end
+
+            S_LOAD:      next_state = S_RUN;
+
+            S_RUN: begin
+                if (tail_valid && tail_last && tail_final)
+                    next_state = S_FINAL_SUB;
+            end
+
+            S_FINAL_SUB: next_state = S_DONE;
+
+            S_DONE: begin
+                // wait for start to drop before going back to IDLE
+                if (!start)
+                    next_state = S_IDLE;
+                else
+                    next_state = S_DONE;
+            end
+
+            default:      next_state = S_IDLE;
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,110 @@
+`timescale 1ns / 1ps
+// -----------------------------------------------------------------------------
+// montgomery_mul_systolic_pe.v
+// One processing element of the Tenca-Koc MWR2MM systolic array
+//
+// Handles one bit x_i of B for a stream of E words of S, A (Y) and N (M),
+// one word per clock:
+//     word 0 : q = (S_0 + x_i*Y_0)[0],  C = 0
+//     word j : (C, S_j) = S_j + x_i*Y_j + q*M_j + C
+// and emits (S + x_i*Y + q*M) / 2 as a word stream. Output word j needs
+// bit 0 of sum word j+1, so the output stream is the input stream delayed
+// by exactly two clocks; Y, M, the x-bit vector and the stream flags are
+// delayed by the same amount so they stay aligned for the next PE.
+//
+// A new stream may start on the clock right after the last word of the
+// previous one (the flush of the last output word overlaps word 0).
+// -----------------------------------------------------------------------------
+module montgomery_mul_systolic_pe #(
+    parameter integer WORD_W = 32,
+    parameter integer XV_W   = 1             // x bits travelling with the stream
+)(
+    input  wire                 clk,
+    input  wire                 rst,         // synchronous, active high
+
+    input  wire                 in_valid,
+    input  wire                 in_first,    // word 0 of a stream
+    input  wire                 in_last,     // word E-1 of a stream
+    input  wire [WORD_W-1:0]    in_s,
+    input  wire [WORD_W-1:0]    in_y,
+    input  wire [WORD_W-1:0]    in_m,
+    input  wire [XV_W-1:0]      in_xv,       // bit 0 is this PE's x_i (on in_first)
+
+    output reg                  out_valid,
+    output reg                  out_first,
+    output reg                  out_last,
+    output reg  [WORD_W-1:0]    out_s,
+    output reg  [WORD_W-1:0]    out_y,
+    output reg  [WORD_W-1:0]    out_m,
+    output reg  [XV_W-1:0]      out_xv       // in_xv >> 1
+);
+
+    // per-stream state
+    reg                 x_reg;
+    reg                 q_reg;
+    reg [1:0]           c_reg;
+    reg [WORD_W-1:0]    prev;       // previous sum word, waiting for its top bit
+
+    // first delay stage (second stage is the out_* registers)
+    reg                 valid_d1, first_d1, last_d1;
+    reg [WORD_W-1:0]    y_d1, m_d1;
+    reg [XV_W-1:0]      xv_d1;
+
+    wire                x_cur = in_first ? in_xv[0] : x_reg;
+    wire                q_cur = in_first ? (in_s[0] ^ (x_cur & in_y[0])) : q_reg;
+    wire [1:0]          c_cur = in_first ? 2'b00 : c_reg;
+
+    wire [WORD_W+1:0]   sum = {2'b00, in_s}
+                            + (x_cur ? {2'b00, in_y} : {(WORD_W+2){1'b0}})
+                            + (q_cur ? {2'b00, in_m} : {(WORD_W+2){1'b0}})
+                            + {{WORD_W{1'b0}}, c_cur};
+
+    // top bit of the word being emitted: LSB of the next sum word, or 0
+    // when the previous word was the last of its stream
+    wire                next_bit = last_d1 ? 1'b0 : sum[0];
+
+    always @(posedge clk) begin
+        if (rst) begin
+            x_reg     <= 1'b0;
+            q_reg     <= 1'b0;
+            c_reg     <= 2'b00;
+            prev      <= {WORD_W{1'b0}};
+            valid_d1  <= 1'b0;
+            first_d1  <= 1'b0;
+            last_d1   <= 1'b0;
+            y_d1      <= {WORD_W{1'b0}};
+            m_d1      <= {WORD_W{1'b0}};
+            xv_d1     <= {XV_W{1'b0}};
+            out_valid <= 1'b0;
+            out_first <= 1'b0;
+            out_last  <= 1'b0;
+            out_s     <= {WORD_W{1'b0}};
+            out_y     <= {WORD_W{1'b0}};
+            out_m     <= {WORD_W{1'b0}};
+            out_xv    <= {XV_W{1'b0}};
+        end else begin
+            if (in_valid) begin
+                x_reg <= x_cur;
+                q_reg <= q_cur;
+                c_reg <= sum[WORD_W+1:WORD_W];
+                prev  <= sum[WORD_W-1:0];
+            end
+
+            valid_d1  <= in_valid;
+            first_d1  <= in_valid & in_first;
+            last_d1   <= in_valid & in_last;
+            y_d1      <= in_y;
+            m_d1      <= in_m;
+            xv_d1     <= in_xv >> 1;
+
+            out_valid <= valid_d1;
+            out_first <= first_d1;
+            out_last  <= last_d1;
+            out_s     <= {next_bit, prev[WORD_W-1:1]};
+            out_y     <= y_d1;
+            out_m     <= m_d1;
+            out_xv    <= xv_d1;
+        end
+    end
+
+endmodule
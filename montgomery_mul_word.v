@@ -0,0 +1,343 @@
+`timescale 1ns / 1ps
+// -----------------------------------------------------------------------------
+// montgomery_mul_word.v
+// Word-serial radix-2^32 Montgomery multiplier (hardware CIOS on DSP48s)
+//
+// Computes: result = A * B * R^{-1} mod N, where R = 2^n_len.
+//
+// One outer iteration per 32-bit word b_i of B (L = n_len/32 iterations):
+//   S_MCALC : m = (T_0 + a_0*b_i) * n' mod 2^32        (n' = -N^{-1} mod 2^32)
+//   S_ROW   : for every word j, COLS words per clock,
+//                 p_j = T_j + a_j*b_i + m*n_j
+//             T is held redundantly as a word vector t plus a 34-bit carry
+//             per word, so a column never waits for its right neighbour:
+//                 t_j <= p_j mod 2^32,   c_j <= p_j / 2^32
+//             and the division by 2^32 is folded into the next read
+//             (column j reads t_{j+1} and c_j).
+// After the last word, S_RESOLVE folds t and c into T and forms T - N one
+// word per clock; S_FINAL_SUB picks the reduced value.
+//
+// n_len is N_BITS or, when N_BITS is a multiple of 512, any multiple of 512
+// below it (operand bits from n_len up must be 0). The vectors then rotate
+// within their low L words only: each word that can be the top of such a
+// ring gets one extra mux input, so the rows and the resolve take L/COLS and
+// L clocks. Words above L are not used and left undefined; result is masked.
+//
+// Each column needs two 32x32 products, so a COLS-wide row uses 2*COLS + 2
+// multipliers (Vivado maps each onto a DSP48E1 cascade).
+//
+// Latency: 1 + L*(1 + L/COLS) + L + 2 clocks, L = n_len/32
+//          (643 clocks for n_len = 2048, 195 for 1024, COLS = 8).
+//
+// Drop-in replacement for montgomery_mul (same ports), selected in
+// montgomery_axi with CORE_TYPE = 4. Unlike the radix-2/4 cores this one
+// uses the n_prime input.
+// -----------------------------------------------------------------------------
+module montgomery_mul_word #(
+    parameter integer N_BITS = 2048,         // must be >= 64, multiple of 32
+    parameter integer COLS   = 8             // words per clock, < N_BITS/32, divides it and 16
+)(
+    input  wire                    clk,
+    input  wire                    rst,      // synchronous, active high
+    input  wire                    start,    // 1-cycle pulse
+
+    input  wire [N_BITS-1:0]       a_in,     // operand A
+    input  wire [N_BITS-1:0]       b_in,     // operand B
+    input  wire [N_BITS-1:0]       n_in,     // modulus N (odd, N < R)
+    input  wire [31:0]             n_prime,  // -N^{-1} mod 2^32
+    input  wire [$clog2(N_BITS):0] n_len,    // modulus length in bits
+
+    output reg  [N_BITS-1:0]       result,   // Montgomery product
+    output reg                     done,     // 1-cycle pulse when result valid
+
+    // optional debug outputs
+    output reg  [2:0]              dbg_state,
+    output reg  [$clog2(N_BITS):0] dbg_bit_idx
+);
+
+    // FSM states
+    localparam [2:0]
+        S_IDLE      = 3'd0,
+        S_LOAD      = 3'd1,
+        S_MCALC     = 3'd2,
+        S_ROW       = 3'd3,
+        S_RESOLVE   = 3'd4,
+        S_FINAL_SUB = 3'd5,
+        S_DONE      = 3'd6;
+
+    localparam integer S_WORDS = N_BITS / 32;
+    localparam integer GROUPS  = S_WORDS / COLS;
+    localparam integer CW      = 34;             // per-word carry width
+    localparam integer IW      = $clog2(S_WORDS) + 1;
+    localparam integer GW      = $clog2(GROUPS) + 1;
+    localparam integer STEP    = 16;             // n_len granularity, words
+    localparam integer VARLEN  = (S_WORDS % STEP == 0);
+
+    reg [2:0]               state, next_state;
+
+    // Internals (a, n, t and c rotate right by COLS words per S_ROW clock,
+    // so the active column group is always at the bottom)
+    reg [N_BITS-1:0]        a_reg;
+    reg [N_BITS-1:0]        b_reg;   // shifted right by one word per iteration
+    reg [N_BITS-1:0]        n_reg;
+    reg [N_BITS-1:0]        t_vec;
+    reg [S_WORDS*CW-1:0]    c_vec;
+    reg [31:0]              np_reg;
+    reg [31:0]              m_reg;
+    reg [IW-1:0]            word_idx;
+    reg [GW-1:0]            grp_idx;
+
+    reg [N_BITS-1:0]        t_acc;   // resolved T     (filled from the top)
+    reg [N_BITS-1:0]        d_acc;   // resolved T - N
+    reg [3:0]               res_carry;
+    reg                     res_borrow;
+    reg [IW-1:0]            res_idx;
+
+    wire [IW-1:0]           len_w    = n_len[$clog2(N_BITS):5];   // L
+    wire [31:0]             b_word   = b_reg[31:0];
+    wire                    last_grp = (grp_idx == len_w / COLS - 1);
+
+    // -------------------------------------------------------------------------
+    // Quotient digit: m = (t_1 + c_0 + a_0*b_i) * n' mod 2^32
+    // -------------------------------------------------------------------------
+    (* use_dsp = "yes" *) wire [63:0] m_ab  = a_reg[31:0] * b_word;
+    wire [31:0]             m_u   = t_vec[63:32] + c_vec[31:0] + m_ab[31:0];
+    (* use_dsp = "yes" *) wire [63:0] m_mul = m_u * np_reg;
+
+    // -------------------------------------------------------------------------
+    // One row group: COLS columns in parallel
+    // -------------------------------------------------------------------------
+    wire [32*COLS-1:0]      row_t;
+    wire [CW*COLS-1:0]      row_c;
+
+    genvar gk;
+    generate
+        for (gk = 0; gk < COLS; gk = gk + 1) begin : ROW
+            wire [31:0] t_in;
+
+            if (gk < COLS-1) begin : T_SAME
+                assign t_in = t_vec[32*(gk+1) +: 32];
+            end else begin : T_NEXT
+                // first word of the next group; nothing above the top word
+                assign t_in = last_grp ? 32'd0 : t_vec[32*COLS +: 32];
+            end
+
+            (* use_dsp = "yes" *) wire [63:0] ab = a_reg[32*gk +: 32] * b_word;
+            (* use_dsp = "yes" *) wire [63:0] mn = m_reg * n_reg[32*gk +: 32];
+
+            wire [65:0] p = {34'd0, t_in} + {32'd0, c_vec[CW*gk +: CW]}
+                          + {2'b00, ab} + {2'b00, mn};
+
+            assign row_t[32*gk +: 32] = p[31:0];
+            assign row_c[CW*gk +: CW] = p[65:32];
+        end
+    endgenerate
+
+    // -------------------------------------------------------------------------
+    // Resolve one word: T_r = t_{r+1} + c_r + cy,  D_r = T_r - n_r - bw
+    // -------------------------------------------------------------------------
+    wire [31:0]             r_t    = (res_idx == len_w - 1'b1) ? 32'd0 : t_vec[63:32];
+    wire [35:0]             r_sum  = {4'd0, r_t} + {2'd0, c_vec[CW-1:0]} + {32'd0, res_carry};
+    wire [32:0]             r_diff = {1'b0, r_sum[31:0]} - {1'b0, n_reg[31:0]}
+                                     - {32'd0, res_borrow};
+
+    // -------------------------------------------------------------------------
+    // Rotation within the low L words: word w takes word w + COLS (S_ROW) or
+    // w + 1 (S_RESOLVE); the top COLS / 1 words of the ring take the new row
+    // or wrap around. Only ring tops other than S_WORDS need a second input.
+    // -------------------------------------------------------------------------
+    wire [N_BITS-1:0]       a_row, n_row, t_row;
+    wire [S_WORDS*CW-1:0]   c_row;
+    wire [N_BITS-1:0]       n_res, t_res, acc_t, acc_d;
+    wire [S_WORDS*CW-1:0]   c_res;
+    wire [N_BITS-1:0]       len_mask;
+
+    genvar gw;
+    generate
+        for (gw = 0; gw < S_WORDS; gw = gw + 1) begin : ROT
+            // ring of L = top words that has word gw among its top COLS
+            localparam integer TOP  = (gw / STEP + 1) * STEP;
+            localparam integer WRAP = VARLEN && (TOP < S_WORDS) && (gw >= TOP - COLS);
+            localparam integer SRC  = (gw + COLS) % S_WORDS;
+            localparam integer SRC1 = (gw + 1) % S_WORDS;
+
+            if (WRAP) begin : G_WRAP
+                wire top = (len_w == TOP);
+                assign a_row[32*gw +: 32]  = top ? a_reg[32*(gw+COLS-TOP) +: 32] : a_reg[32*SRC +: 32];
+                assign n_row[32*gw +: 32]  = top ? n_reg[32*(gw+COLS-TOP) +: 32] : n_reg[32*SRC +: 32];
+                assign t_row[32*gw +: 32]  = top ? row_t[32*(gw+COLS-TOP) +: 32] : t_vec[32*SRC +: 32];
+                assign c_row[CW*gw +: CW]  = top ? row_c[CW*(gw+COLS-TOP) +: CW] : c_vec[CW*SRC +: CW];
+            end else if (gw >= S_WORDS - COLS) begin : G_TOP
+                assign a_row[32*gw +: 32]  = a_reg[32*SRC +: 32];
+                assign n_row[32*gw +: 32]  = n_reg[32*SRC +: 32];
+                assign t_row[32*gw +: 32]  = row_t[32*(gw+COLS-S_WORDS) +: 32];
+                assign c_row[CW*gw +: CW]  = row_c[CW*(gw+COLS-S_WORDS) +: CW];
+            end else begin : G_SHIFT
+                assign a_row[32*gw +: 32]  = a_reg[32*SRC +: 32];
+                assign n_row[32*gw +: 32]  = n_reg[32*SRC +: 32];
+                assign t_row[32*gw +: 32]  = t_vec[32*SRC +: 32];
+                assign c_row[CW*gw +: CW]  = c_vec[CW*SRC +: CW];
+            end
+
+            if (VARLEN && gw % STEP == STEP - 1 && gw < S_WORDS - 1) begin : G_WRAP1
+                wire top = (len_w == gw + 1);
+                assign n_res[32*gw +: 32]  = top ? n_reg[31:0]  : n_reg[32*SRC1 +: 32];
+                assign t_res[32*gw +: 32]  = top ? t_vec[31:0]  : t_vec[32*SRC1 +: 32];
+                assign c_res[CW*gw +: CW]  = top ? c_vec[CW-1:0] : c_vec[CW*SRC1 +: CW];
+                assign acc_t[32*gw +: 32]  = top ? r_sum[31:0]  : t_acc[32*gw+32 +: 32];
+                assign acc_d[32*gw +: 32]  = top ? r_diff[31:0] : d_acc[32*gw+32 +: 32];
+            end else if (gw == S_WORDS - 1) begin : G_TOP1
+                assign n_res[32*gw +: 32]  = n_reg[31:0];
+                assign t_res[32*gw +: 32]  = t_vec[31:0];
+                assign c_res[CW*gw +: CW]  = c_vec[CW-1:0];
+                assign acc_t[32*gw +: 32]  = r_sum[31:0];
+                assign acc_d[32*gw +: 32]  = r_diff[31:0];
+            end else begin : G_SHIFT1
+                assign n_res[32*gw +: 32]  = n_reg[32*SRC1 +: 32];
+                assign t_res[32*gw +: 32]  = t_vec[32*SRC1 +: 32];
+                assign c_res[CW*gw +: CW]  = c_vec[CW*SRC1 +: CW];
+                assign acc_t[32*gw +: 32]  = t_acc[32*gw+32 +: 32];
+                assign acc_d[32*gw +: 32]  = d_acc[32*gw+32 +: 32];
+            end
+
+            assign len_mask[32*gw +: 32] = {32{gw < len_w}};
+        end
+    endgenerate
+
+    // -------------------------------------------------------------------------
+    // Sequential logic
+    // -------------------------------------------------------------------------
+    always @(posedge clk) begin
+        if (rst) begin
+            state       <= S_IDLE;
+            done        <= 1'b0;
+            a_reg       <= {N_BITS{1'b0}};
+            b_reg       <= {N_BITS{1'b0}};
+            n_reg       <= {N_BITS{1'b0}};
+            t_vec       <= {N_BITS{1'b0}};
+            c_vec       <= {(S_WORDS*CW){1'b0}};
+            np_reg      <= 32'd0;
+            m_reg       <= 32'd0;
+            word_idx    <= {IW{1'b0}};
+            grp_idx     <= {GW{1'b0}};
+            t_acc       <= {N_BITS{1'b0}};
+            d_acc       <= {N_BITS{1'b0}};
+            res_carry   <= 4'd0;
+            res_borrow  <= 1'b0;
+            res_idx     <= {IW{1'b0}};
+            result      <= {N_BITS{1'b0}};
+            dbg_state   <= S_IDLE;
+            dbg_bit_idx <= {($clog2(N_BITS)+1){1'b0}};
+        end else begin
+            state       <= next_state;
+            done        <= 1'b0;        // default: only assert in S_DONE
+            dbg_state   <= next_state;
+            dbg_bit_idx <= {word_idx, 5'd0};
+
+            case (state)
+                S_IDLE: begin
+                    // wait for start, nothing to do
+                end
+
+                S_LOAD: begin
+                    a_reg      <= a_in;
+                    b_reg      <= b_in;
+                    n_reg      <= n_in;
+                    np_reg     <= n_prime;
+                    t_vec      <= {N_BITS{1'b0}};
+                    c_vec      <= {(S_WORDS*CW){1'b0}};
+                    word_idx   <= {IW{1'b0}};
+                    res_carry  <= 4'd0;
+                    res_borrow <= 1'b0;
+                    res_idx    <= {IW{1'b0}};
+                end
+
+                S_MCALC: begin
+                    m_reg   <= m_mul[31:0];
+                    grp_idx <= {GW{1'b0}};
+                end
+
+                S_ROW: begin
+                    t_vec   <= t_row;
+                    c_vec   <= c_row;
+                    a_reg   <= a_row;
+                    n_reg   <= n_row;
+                    grp_idx <= grp_idx + 1'b1;
+                    if (last_grp) begin
+                        b_reg    <= {32'd0, b_reg[N_BITS-1:32]};
+                        word_idx <= word_idx + 1'b1;
+                    end
+                end
+
+                S_RESOLVE: begin
+                    t_acc      <= acc_t;
+                    d_acc      <= acc_d;
+                    res_carry  <= r_sum[35:32];
+                    res_borrow <= r_diff[32];
+                    t_vec      <= t_res;
+                    c_vec      <= c_res;
+                    n_reg      <= n_res;
+                    res_idx    <= res_idx + 1'b1;
+                end
+
+                S_FINAL_SUB: begin
+                    // T >= N if T overflowed n_len or T - N did not borrow
+                    if (res_carry != 4'd0 || !res_borrow)
+                        t_acc <= d_acc;
+                end
+
+                S_DONE: begin
+                    result <= t_acc & len_mask;
+                    done   <= 1'b1;   // 1-cycle pulse
+                end
+
+                default: ;
+            endcase
+        end
+    end
+
+    // -------------------------------------------------------------------------
+    // Next-state logic
+    // -------------------------------------------------------------------------
+    always @(*) begin
+        next_state = state;
+        case (state)
+            S_IDLE: begin
+                if (start)
+                    next_state = S_LOAD;
+            end
+
+            S_LOAD:      next_state = S_MCALC;
+            S_MCALC:     next_state = S_ROW;
+
+            S_ROW: begin
+                if (!last_grp)
+                    next_state = S_ROW;
+                else if (word_idx == len_w - 1'b1)
+                    next_state = S_RESOLVE;
+                else
+                    next_state = S_MCALC;
+            end
+
+            S_RESOLVE: begin
+                if (res_idx == len_w - 1'b1)
+                    next_state = S_FINAL_SUB;
+                else
+                    next_state = S_RESOLVE;
+            end
+
+            S_FINAL_SUB: next_state = S_DONE;
+
+            S_DONE: begin
+                // wait for start to drop before going back to IDLE
+                if (!start)
+                    next_state = S_IDLE;
+                else
+                    next_state = S_DONE;
+            end
+
+            default:      next_state = S_IDLE;
+        endcase
+    end
+
+endmodule
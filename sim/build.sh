@@ -0,0 +1,42 @@
+#!/bin/sh
+# -----------------------------------------------------------------------------
+# build.sh
+# Verilate montgomery_axi (2048- and 1024-bit, with the DMA master and a
+# simulated DDR behind it) and link the host benchmark against it:
+#   sim/build.sh && MONT_BACKEND=verilator ./sim/rsa_bench_sim
+#
+# Extra Verilator flags go in $VFLAGS_EXTRA, e.g. to pick a core variant:
+#   VFLAGS_EXTRA=-GCORE_TYPE=1 sim/build.sh
+# and extra C flags in $CFLAGS_EXTRA (e.g. -DNUM_RUNS=1). $BIN names the
+# output binary.
+# -----------------------------------------------------------------------------
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=${OUT:-$ROOT/sim/obj_dir}
+BIN=${BIN:-$ROOT/sim/rsa_bench_sim}
+RTL="$ROOT/montgomery_axi.v $ROOT/montgomery_lane.v $ROOT/montgomery_dma.v $ROOT/montgomery_mul.v $ROOT/montgomery_mul_1cyc.v \
+     $ROOT/montgomery_mul_csa.v $ROOT/montgomery_mul_r4.v $ROOT/montgomery_mul_word.v \
+     $ROOT/montgomery_mul_systolic.v $ROOT/montgomery_mul_systolic_pe.v"
+VFLAGS="--cc --build -O3 -Wno-fatal --top-module montgomery_axi -GDMA_EN=1 $VFLAGS_EXTRA"
+
+verilator $VFLAGS --prefix Vmontgomery_axi      -GN_BITS=2048 -Mdir "$OUT/v2048" $RTL
+verilator $VFLAGS --prefix Vmontgomery_axi_1024 -GN_BITS=1024 -Mdir "$OUT/v1024" $RTL
+
+VROOT=$(verilator --getenv VERILATOR_ROOT)
+CFLAGS="-O2 -DMONT_HAL_VERILATOR -I$ROOT $CFLAGS_EXTRA"
+CXXFLAGS="$CFLAGS -std=c++17 -I$ROOT/sim -I$OUT/v2048 -I$OUT/v1024 \
+          -I$VROOT/include -I$VROOT/include/vltstd"
+
+mkdir -p "$OUT/host"
+for f in main_1.c mont_sw.c mont_hal.c mont_hal_baremetal.c mont_hal_linux.c mont_hal_model.c; do
+    gcc -std=gnu11 $CFLAGS -c "$ROOT/$f" -o "$OUT/host/${f%.c}.o"
+done
+g++ $CXXFLAGS -c "$ROOT/sim/mont_hal_verilator.cpp" -o "$OUT/host/mont_hal_verilator.o"
+
+g++ -o "$BIN" "$OUT"/host/*.o \
+    "$OUT/v2048/Vmontgomery_axi__ALL.a" \
+    "$OUT/v1024/Vmontgomery_axi_1024__ALL.a" \
+    "$OUT/v2048/libverilated.a" -pthread -latomic
+
+echo "built $BIN"
@@ -0,0 +1,380 @@
+/* -------------------------------------------------------------------------- */
+/* fake_uio.c                                                                 */
+/* LD_PRELOAD stand-in for /dev/uio0 (2048-bit) and /dev/uio1 (1024-bit),     */
+/* backed by the software model (mont_hal_model.c), so the uio backend runs   */
+/* unchanged on an x86-64 host:  sim/fake_uio.sh                              */
+/*                                                                            */
+/* open/mmap/read/write/poll/close on those paths are intercepted. The        */
+/* mapped register window is a PROT_NONE page: every access faults, the       */
+/* SIGSEGV handler gets address and direction, opens the page and single-     */
+/* steps the instruction (trap flag), and the SIGTRAP handler hands the       */
+/* access to the model and closes the page again.                             */
+/*                                                                            */
+/* The model finishes a job at once; the fake reports STATUS busy for         */
+/* $FAKE_UIO_POLLS reads (default 1000) or until the driver sleeps in         */
+/* poll()/read(), then raises the done interrupt the way uio_pdrv_genirq      */
+/* would (count + 1, line masked until a write of 1). Both halves of the      */
+/* spin-then-block wait therefore run.                                        */
+/* -------------------------------------------------------------------------- */
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "mont_hal.h"
+
+#define EXPORT          __attribute__((visibility("default")))
+#define FAKE_NUM_DEVS   2
+#define X86_EFLAGS_TF   0x100
+
+typedef struct {
+    const char   *path;
+    u32           nwords;
+    int           fd;           /* /dev/null placeholder, -1 when closed */
+    volatile u32 *win;          /* register window, PROT_NONE between accesses */
+    mont_dev_t    model;
+    u32           running;      /* job started, interrupt not raised yet */
+    u32           polls;        /* STATUS reads since the start */
+    u32           irq_en;
+    u32           irq_stat;
+    u32           unmasked;     /* line enabled (write 1 to the fd) */
+    u32           events;       /* interrupt count, value of read() */
+    u32           seen;         /* count at the last read() */
+} fake_dev_t;
+
+static fake_dev_t fake_devs[FAKE_NUM_DEVS] = {
+    { "/dev/uio0", NWORDS_2048, -1, NULL },
+    { "/dev/uio1", NWORDS_1024, -1, NULL },
+};
+static u32 fake_polls = 1000U;
+
+static int     (*real_open)(const char *, int, ...);
+static ssize_t (*real_read)(int, void *, size_t);
+static ssize_t (*real_write)(int, const void *, size_t);
+static int     (*real_poll)(struct pollfd *, nfds_t, int);
+static int     (*real_close)(int);
+static void   *(*real_mmap)(void *, size_t, int, int, int, off_t);
+static int     (*real_munmap)(void *, size_t);
+
+/* access in flight between the two signal handlers */
+static fake_dev_t *trap_dev;
+static u32         trap_off;
+static int         trap_write;
+
+/* mont_hal_model.c points wait_done here; the fake never calls it */
+int mont_hal_poll_done(mont_dev_t *dev, u32 max_polls)
+{
+    (void)dev;
+    (void)max_polls;
+    return 1;
+}
+
+static void fake_resolve(void)
+{
+    if (real_open != NULL)
+        return;
+    real_open   = (int (*)(const char *, int, ...))dlsym(RTLD_NEXT, "open");
+    real_read   = (ssize_t (*)(int, void *, size_t))dlsym(RTLD_NEXT, "read");
+    real_write  = (ssize_t (*)(int, const void *, size_t))dlsym(RTLD_NEXT, "write");
+    real_poll   = (int (*)(struct pollfd *, nfds_t, int))dlsym(RTLD_NEXT, "poll");
+    real_close  = (int (*)(int))dlsym(RTLD_NEXT, "close");
+    real_mmap   = (void *(*)(void *, size_t, int, int, int, off_t))dlsym(RTLD_NEXT, "mmap");
+    real_munmap = (int (*)(void *, size_t))dlsym(RTLD_NEXT, "munmap");
+}
+
+static fake_dev_t *fake_by_fd(int fd)
+{
+    for (u32 i = 0; i < FAKE_NUM_DEVS; ++i)
+        if (fd >= 0 && fake_devs[i].fd == fd)
+            return &fake_devs[i];
+    return NULL;
+}
+
+static fake_dev_t *fake_by_addr(uintptr_t a)
+{
+    for (u32 i = 0; i < FAKE_NUM_DEVS; ++i) {
+        uintptr_t w = (uintptr_t)fake_devs[i].win;
+        if (w != 0U && a >= w && a < w + MONT_REG_SPAN)
+            return &fake_devs[i];
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Device                                                                   */
+/* ------------------------------------------------------------------------ */
+
+/* level interrupt into uio_pdrv_genirq: count it and mask the line */
+static void fake_irq(fake_dev_t *d)
+{
+    if (d->irq_en && d->irq_stat && d->unmasked) {
+        ++d->events;
+        d->unmasked = 0U;
+    }
+}
+
+static void fake_complete(fake_dev_t *d)
+{
+    if (!d->running)
+        return;
+    d->running  = 0U;
+    d->irq_stat = 1U;
+    fake_irq(d);
+}
+
+static u32 fake_reg_read(fake_dev_t *d, u32 off)
+{
+    if (off == REG_IRQ_ENABLE)
+        return d->irq_en;
+    if (off == REG_IRQ_STATUS)
+        return d->irq_stat;
+    if (off == REG_STATUS && d->running) {
+        if (++d->polls < fake_polls)
+            return STATUS_BUSY;
+        fake_complete(d);
+    }
+    return d->model.ops->read_reg(&d->model, off);
+}
+
+static void fake_reg_write(fake_dev_t *d, u32 off, u32 val)
+{
+    if (off == REG_IRQ_ENABLE) {
+        d->irq_en = val & IRQ_DONE;
+    } else if (off == REG_IRQ_STATUS) {
+        if (val & IRQ_DONE)
+            d->irq_stat = 0U;
+    } else {
+        d->model.ops->write_reg(&d->model, off, val);
+        if (off == REG_CONTROL && (val & CONTROL_START)) {
+            d->running = 1U;
+            d->polls   = 0U;
+        }
+    }
+    fake_irq(d);
+}
+
+/* ------------------------------------------------------------------------ */
+/* MMIO trap                                                                */
+/* ------------------------------------------------------------------------ */
+
+static void fake_on_segv(int sig, siginfo_t *si, void *ctx)
+{
+    ucontext_t *uc = (ucontext_t *)ctx;
+    fake_dev_t *d  = fake_by_addr((uintptr_t)si->si_addr);
+
+    if (d == NULL) {
+        /* a real crash: fault again with the default action */
+        signal(sig, SIG_DFL);
+        return;
+    }
+
+    trap_dev   = d;
+    trap_off   = (u32)((uintptr_t)si->si_addr - (uintptr_t)d->win) & ~3U;
+    trap_write = (uc->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+
+    mprotect((void *)d->win, MONT_REG_SPAN, PROT_READ | PROT_WRITE);
+    if (!trap_write)
+        d->win[trap_off / 4U] = fake_reg_read(d, trap_off);
+    uc->uc_mcontext.gregs[REG_EFL] |= X86_EFLAGS_TF;
+}
+
+static void fake_on_trap(int sig, siginfo_t *si, void *ctx)
+{
+    ucontext_t *uc = (ucontext_t *)ctx;
+    fake_dev_t *d  = trap_dev;
+
+    (void)si;
+    if (d == NULL) {
+        signal(sig, SIG_DFL);
+        return;
+    }
+
+    uc->uc_mcontext.gregs[REG_EFL] &= ~X86_EFLAGS_TF;
+    if (trap_write)
+        fake_reg_write(d, trap_off, d->win[trap_off / 4U]);
+    mprotect((void *)d->win, MONT_REG_SPAN, PROT_NONE);
+    trap_dev = NULL;
+}
+
+static int fake_attach(fake_dev_t *d)
+{
+    static int handlers;
+    const char *p = getenv("FAKE_UIO_POLLS");
+
+    if (p != NULL && p[0] != '\0')
+        fake_polls = (u32)strtoul(p, NULL, 0);
+
+    if (!handlers) {
+        struct sigaction sa;
+
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_flags     = SA_SIGINFO;
+        sa.sa_sigaction = fake_on_segv;
+        sigaction(SIGSEGV, &sa, NULL);
+        sa.sa_sigaction = fake_on_trap;
+        sigaction(SIGTRAP, &sa, NULL);
+        handlers = 1;
+    }
+
+    if (d->win == NULL) {
+        void *w = real_mmap(NULL, MONT_REG_SPAN, PROT_NONE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (w == MAP_FAILED || !mont_hal_model_open(&d->model, d->nwords))
+            return 0;
+        d->win = (volatile u32 *)w;
+    }
+
+    d->fd = real_open("/dev/null", O_RDWR);
+    return d->fd >= 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Interposed libc calls                                                    */
+/* ------------------------------------------------------------------------ */
+
+EXPORT int open(const char *path, int flags, ...)
+{
+    mode_t mode = 0;
+    va_list ap;
+
+    fake_resolve();
+    for (u32 i = 0; i < FAKE_NUM_DEVS; ++i) {
+        if (strcmp(path, fake_devs[i].path) == 0) {
+            if (fake_devs[i].fd >= 0 || !fake_attach(&fake_devs[i])) {
+                errno = EBUSY;
+                return -1;
+            }
+            return fake_devs[i].fd;
+        }
+    }
+
+    if (flags & (O_CREAT | O_TMPFILE)) {
+        va_start(ap, flags);
+        mode = (mode_t)va_arg(ap, int);
+        va_end(ap);
+    }
+    return real_open(path, flags, mode);
+}
+
+EXPORT int open64(const char *path, int flags, ...)
+{
+    mode_t mode = 0;
+    va_list ap;
+
+    if (flags & (O_CREAT | O_TMPFILE)) {
+        va_start(ap, flags);
+        mode = (mode_t)va_arg(ap, int);
+        va_end(ap);
+    }
+    return open(path, flags, mode);
+}
+
+EXPORT void *mmap(void *addr, size_t len, int prot, int flags, int fd, off_t off)
+{
+    fake_dev_t *d;
+
+    fake_resolve();
+    if ((d = fake_by_fd(fd)) == NULL)
+        return real_mmap(addr, len, prot, flags, fd, off);
+
+    /* map 0 only, at most one page */
+    if (off != 0 || len > MONT_REG_SPAN) {
+        errno = EINVAL;
+        return MAP_FAILED;
+    }
+    return (void *)d->win;
+}
+
+EXPORT void *mmap64(void *addr, size_t len, int prot, int flags, int fd, off_t off)
+{
+    return mmap(addr, len, prot, flags, fd, off);
+}
+
+EXPORT int munmap(void *addr, size_t len)
+{
+    fake_resolve();
+    if (fake_by_addr((uintptr_t)addr) != NULL)
+        return 0;           /* the window lives as long as the process */
+    return real_munmap(addr, len);
+}
+
+/* interrupt count; a job still "running" finishes while the caller sleeps */
+EXPORT ssize_t read(int fd, void *buf, size_t n)
+{
+    fake_dev_t *d;
+
+    fake_resolve();
+    if ((d = fake_by_fd(fd)) == NULL)
+        return real_read(fd, buf, n);
+
+    if (n != sizeof(u32)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (d->events == d->seen)
+        fake_complete(d);
+    if (d->events == d->seen) {
+        errno = EAGAIN;     /* the real device would block forever */
+        return -1;
+    }
+    d->seen = d->events;
+    memcpy(buf, &d->seen, sizeof(u32));
+    return (ssize_t)sizeof(u32);
+}
+
+/* 1 unmasks the interrupt line, 0 masks it */
+EXPORT ssize_t write(int fd, const void *buf, size_t n)
+{
+    fake_dev_t *d;
+    u32 v;
+
+    fake_resolve();
+    if ((d = fake_by_fd(fd)) == NULL)
+        return real_write(fd, buf, n);
+
+    if (n != sizeof(u32)) {
+        errno = EINVAL;
+        return -1;
+    }
+    memcpy(&v, buf, sizeof(v));
+    d->unmasked = (v != 0U);
+    fake_irq(d);
+    return (ssize_t)sizeof(u32);
+}
+
+EXPORT int poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    fake_dev_t *d;
+
+    fake_resolve();
+    if (nfds != 1 || (d = fake_by_fd(fds[0].fd)) == NULL)
+        return real_poll(fds, nfds, timeout);
+
+    if (d->events == d->seen)
+        fake_complete(d);
+    if (d->events == d->seen) {
+        real_poll(NULL, 0, timeout);    /* nothing will come: time out */
+        fds[0].revents = 0;
+        return 0;
+    }
+    fds[0].revents = POLLIN;
+    return 1;
+}
+
+EXPORT int close(int fd)
+{
+    fake_dev_t *d;
+
+    fake_resolve();
+    if ((d = fake_by_fd(fd)) != NULL)
+        d->fd = -1;
+    return real_close(fd);
+}
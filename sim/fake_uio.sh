@@ -0,0 +1,23 @@
+#!/bin/sh
+# -----------------------------------------------------------------------------
+# fake_uio.sh
+# Run the benchmark through the uio backend on an x86-64 host, against the
+# fake /dev/uio0 and /dev/uio1 of fake_uio.c (software model behind a
+# trapped register window, interrupts through read() on the fd):
+#   sim/fake_uio.sh                 (blocks on the interrupt for every job)
+#   FAKE_UIO_POLLS=10 sim/fake_uio.sh   (short jobs finish while spinning)
+#   CFLAGS_EXTRA=-DNUM_RUNS=1 sim/fake_uio.sh   (one run per case)
+# -----------------------------------------------------------------------------
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=${OUT:-$ROOT/sim/obj_dir/uio}
+
+mkdir -p "$OUT"
+gcc -O2 -std=gnu11 -shared -fPIC -fvisibility=hidden -I"$ROOT" \
+    -o "$OUT/fake_uio.so" "$ROOT/sim/fake_uio.c" \
+    "$ROOT/mont_hal_model.c" "$ROOT/mont_sw.c" -ldl
+gcc -O2 -std=gnu11 -I"$ROOT" $CFLAGS_EXTRA -o "$OUT/rsa_bench" \
+    "$ROOT/main_1.c" "$ROOT/mont_sw.c" "$ROOT"/mont_hal*.c
+
+LD_PRELOAD="$OUT/fake_uio.so" MONT_BACKEND=uio "$OUT/rsa_bench"
@@ -0,0 +1,298 @@
+// -----------------------------------------------------------------------------
+// mont_axi_sim.h
+// Cycle-accurate AXI4-Lite master around a Verilated montgomery_axi
+//
+// Every register access is a real AW/W/B or AR/R handshake on the Verilated
+// s_axi_* ports, and s_axi_aclk is advanced one full period per tick(), so
+// cycles() is the exact number of accelerator clocks the driver has spent,
+// bus overhead included.
+//
+// core_clk (CORE_CLK_ASYNC builds) follows s_axi_aclk edge for edge unless
+// MONT_CORE_PS is set: then it is a free-running clock with that period in
+// ps against an s_axi_aclk period of MONT_AXI_PS (default 10000), and its
+// edges are applied in time order between the s_axi ones.
+//
+// The m_axi_* master (DMA_EN builds) sees a DDR slave with DMA_WORDS words
+// at DMA_PHYS: one burst each way at a time, one beat per clock, SLVERR
+// outside the window.
+// -----------------------------------------------------------------------------
+#ifndef MONT_AXI_SIM_H
+#define MONT_AXI_SIM_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "verilated.h"
+
+class MontAxiSim {
+public:
+    virtual ~MontAxiSim() {}
+
+    virtual void     reset(unsigned cycles = 4) = 0;
+    virtual void     write32(uint32_t addr, uint32_t data) = 0;
+    virtual uint32_t read32(uint32_t addr) = 0;
+    virtual void     idle(uint64_t cycles) = 0;
+    virtual bool     irq() = 0;
+
+    uint64_t cycles() const { return cycles_; }
+
+    static constexpr uint32_t DMA_PHYS  = 0x1FF00000u;
+    static constexpr uint32_t DMA_WORDS = 256u * 1024u;     // 1 MB
+
+    // bump allocator in the simulated DDR, nullptr when it is full
+    void *dma_alloc(uint32_t bytes, uint32_t *phys)
+    {
+        uint32_t words = (bytes + 3u) / 4u;
+
+        if (words > DMA_WORDS - dma_used_)
+            return nullptr;
+        *phys = DMA_PHYS + 4u * dma_used_;
+        dma_used_ += words;
+        return &ddr_[*phys / 4u - DMA_PHYS / 4u];
+    }
+
+protected:
+    uint64_t              cycles_   = 0;
+    std::vector<uint32_t> ddr_      = std::vector<uint32_t>(DMA_WORDS);
+    uint32_t              dma_used_ = 0;
+};
+
+template <class VTop>
+class MontAxiSimImpl : public MontAxiSim {
+public:
+    MontAxiSimImpl()
+        : ctx_(new VerilatedContext), top_(new VTop(ctx_.get()))
+    {
+        const char *axi_ps  = std::getenv("MONT_AXI_PS");
+        const char *core_ps = std::getenv("MONT_CORE_PS");
+
+        // times in half-ps, so a half period is the period in ps
+        axi_half_  = axi_ps  ? std::strtoull(axi_ps,  nullptr, 0) : 10000u;
+        core_half_ = core_ps ? std::strtoull(core_ps, nullptr, 0) : 0u;
+        if (axi_half_ == 0)
+            axi_half_ = 10000u;
+        axi_next_  = axi_half_;
+        core_next_ = core_half_;
+
+        top_->s_axi_aclk    = 0;
+        top_->core_clk      = 0;
+        top_->s_axi_aresetn = 0;
+        top_->s_axi_awvalid = 0;
+        top_->s_axi_wvalid  = 0;
+        top_->s_axi_bready  = 0;
+        top_->s_axi_arvalid = 0;
+        top_->s_axi_rready  = 0;
+        top_->s_axi_wstrb   = 0xF;
+        ddr_drive();
+        top_->eval();
+        reset();
+    }
+
+    ~MontAxiSimImpl() override { top_->final(); }
+
+    void reset(unsigned n = 4) override
+    {
+        top_->s_axi_aresetn = 0;
+        for (unsigned i = 0; i < n; ++i)
+            tick();
+        top_->s_axi_aresetn = 1;
+        tick();
+    }
+
+    void write32(uint32_t addr, uint32_t data) override
+    {
+        bool aw_done = false, w_done = false;
+
+        top_->s_axi_awaddr  = addr;
+        top_->s_axi_awvalid = 1;
+        top_->s_axi_wdata   = data;
+        top_->s_axi_wstrb   = 0xF;
+        top_->s_axi_wvalid  = 1;
+        top_->s_axi_bready  = 1;
+        top_->eval();
+
+        // AW and W are accepted independently; drop each valid right after
+        // the edge it was sampled on
+        while (!aw_done || !w_done) {
+            bool aw_hs = top_->s_axi_awvalid && top_->s_axi_awready;
+            bool w_hs  = top_->s_axi_wvalid  && top_->s_axi_wready;
+            tick();
+            if (aw_hs) { aw_done = true; top_->s_axi_awvalid = 0; }
+            if (w_hs)  { w_done  = true; top_->s_axi_wvalid  = 0; }
+        }
+
+        for (;;) {
+            bool b_hs = top_->s_axi_bvalid && top_->s_axi_bready;
+            tick();
+            if (b_hs)
+                break;
+        }
+        top_->s_axi_bready = 0;
+        top_->eval();
+    }
+
+    uint32_t read32(uint32_t addr) override
+    {
+        uint32_t data;
+
+        top_->s_axi_araddr  = addr;
+        top_->s_axi_arvalid = 1;
+        top_->s_axi_rready  = 1;
+        top_->eval();
+
+        for (;;) {
+            bool ar_hs = top_->s_axi_arvalid && top_->s_axi_arready;
+            tick();
+            if (ar_hs) {
+                top_->s_axi_arvalid = 0;
+                break;
+            }
+        }
+
+        for (;;) {
+            bool r_hs = top_->s_axi_rvalid && top_->s_axi_rready;
+            data = top_->s_axi_rdata;
+            tick();
+            if (r_hs)
+                break;
+        }
+        top_->s_axi_rready = 0;
+        top_->eval();
+        return data;
+    }
+
+    void idle(uint64_t n) override
+    {
+        for (uint64_t i = 0; i < n; ++i)
+            tick();
+    }
+
+    bool irq() override { return top_->irq != 0; }
+
+private:
+    // one s_axi_aclk period, with the core_clk edges that fall inside it
+    // (s_axi first on a tie)
+    void tick()
+    {
+        for (int edges = 0; edges < 2; ) {
+            if (core_half_ != 0 && core_next_ < axi_next_) {
+                advance(core_next_);
+                top_->core_clk = !top_->core_clk;
+                top_->eval();
+                core_next_ += core_half_;
+                continue;
+            }
+
+            advance(axi_next_);
+            if (!top_->s_axi_aclk) {
+                ddr_sample();
+                top_->s_axi_aclk = 1;
+                if (core_half_ == 0)
+                    top_->core_clk = 1;
+                top_->eval();
+                ddr_drive();
+            } else {
+                top_->s_axi_aclk = 0;
+                if (core_half_ == 0)
+                    top_->core_clk = 0;
+                top_->eval();
+            }
+            axi_next_ += axi_half_;
+            ++edges;
+        }
+        ++cycles_;
+    }
+
+    void advance(uint64_t t)
+    {
+        ctx_->timeInc(t - now_);
+        now_ = t;
+    }
+
+    // word index of a DDR address, DMA_WORDS when outside the window
+    static uint32_t ddr_index(uint32_t addr)
+    {
+        uint32_t i = (addr - DMA_PHYS) / 4u;
+        return (addr >= DMA_PHYS && i < DMA_WORDS) ? i : DMA_WORDS;
+    }
+
+    // handshakes completed by the coming edge (all sampled before it)
+    void ddr_sample()
+    {
+        bool ar_hs = top_->m_axi_arvalid && top_->m_axi_arready;
+        bool r_hs  = top_->m_axi_rvalid  && top_->m_axi_rready;
+        bool aw_hs = top_->m_axi_awvalid && top_->m_axi_awready;
+        bool w_hs  = top_->m_axi_wvalid  && top_->m_axi_wready;
+        bool b_hs  = top_->m_axi_bvalid  && top_->m_axi_bready;
+
+        if (r_hs && ++rd_beat_ > rd_len_)
+            rd_busy_ = false;
+        if (ar_hs) {
+            rd_busy_ = true;
+            rd_addr_ = top_->m_axi_araddr;
+            rd_len_  = top_->m_axi_arlen;
+            rd_beat_ = 0;
+        }
+
+        if (w_hs) {
+            uint32_t i = ddr_index(wr_addr_ + 4u * wr_beat_);
+            if (i < DMA_WORDS)
+                ddr_[i] = top_->m_axi_wdata;
+            else
+                wr_err_ = true;
+            if (++wr_beat_ > wr_len_) {
+                wr_busy_ = false;
+                b_pend_  = true;
+            }
+        }
+        if (b_hs)
+            b_pend_ = false;
+        if (aw_hs) {
+            wr_busy_ = true;
+            wr_err_  = false;
+            wr_addr_ = top_->m_axi_awaddr;
+            wr_len_  = top_->m_axi_awlen;
+            wr_beat_ = 0;
+        }
+    }
+
+    void ddr_drive()
+    {
+        uint32_t i = ddr_index(rd_addr_ + 4u * rd_beat_);
+
+        top_->m_axi_arready = !rd_busy_;
+        top_->m_axi_rvalid  = rd_busy_;
+        top_->m_axi_rdata   = (i < DMA_WORDS) ? ddr_[i] : 0u;
+        top_->m_axi_rresp   = (i < DMA_WORDS) ? 0u : 2u;
+        top_->m_axi_rlast   = rd_busy_ && rd_beat_ == rd_len_;
+
+        top_->m_axi_awready = !wr_busy_ && !b_pend_;
+        top_->m_axi_wready  = wr_busy_;
+        top_->m_axi_bvalid  = b_pend_;
+        top_->m_axi_bresp   = wr_err_ ? 2u : 0u;
+    }
+
+    bool     rd_busy_ = false;
+    uint32_t rd_addr_ = 0;
+    uint32_t rd_len_  = 0;
+    uint32_t rd_beat_ = 0;
+    bool     wr_busy_ = false;
+    bool     wr_err_  = false;
+    bool     b_pend_  = false;
+    uint32_t wr_addr_ = 0;
+    uint32_t wr_len_  = 0;
+    uint32_t wr_beat_ = 0;
+
+    uint64_t now_       = 0;
+    uint64_t axi_half_  = 10000u;
+    uint64_t axi_next_  = 10000u;
+    uint64_t core_half_ = 0;        // 0: core_clk is s_axi_aclk
+    uint64_t core_next_ = 0;
+
+    std::unique_ptr<VerilatedContext> ctx_;
+    std::unique_ptr<VTop>             top_;
+};
+
+#endif // MONT_AXI_SIM_H
@@ -0,0 +1,116 @@
+// -----------------------------------------------------------------------------
+// mont_hal_verilator.cpp
+// HAL backend on top of the Verilated RTL (see mont_axi_sim.h)
+//
+// Built only with -DMONT_HAL_VERILATOR; sim/build.sh produces both models:
+//   Vmontgomery_axi       montgomery_axi, N_BITS = 2048
+//   Vmontgomery_axi_1024  montgomery_axi, N_BITS = 1024
+// -----------------------------------------------------------------------------
+#include "mont_hal.h"
+#include "mont_axi_sim.h"
+
+#include "Vmontgomery_axi.h"
+#include "Vmontgomery_axi_1024.h"
+
+namespace {
+
+MontAxiSim *sim_of(mont_dev_t *dev)
+{
+    return static_cast<MontAxiSim *>(dev->priv);
+}
+
+void vl_write_block(mont_dev_t *dev, u32 off, const u32 *src, u32 nwords)
+{
+    for (u32 i = 0; i < nwords; ++i)
+        sim_of(dev)->write32(off + 4U * i, src[i]);
+}
+
+void vl_read_block(mont_dev_t *dev, u32 off, u32 *dst, u32 nwords)
+{
+    for (u32 i = 0; i < nwords; ++i)
+        dst[i] = sim_of(dev)->read32(off + 4U * i);
+}
+
+void vl_write_reg(mont_dev_t *dev, u32 off, u32 val)
+{
+    sim_of(dev)->write32(off, val);
+}
+
+u32 vl_read_reg(mont_dev_t *dev, u32 off)
+{
+    return sim_of(dev)->read32(off);
+}
+
+void vl_close(mont_dev_t *dev)
+{
+    delete sim_of(dev);
+    dev->priv = nullptr;
+}
+
+u64 vl_cycles(mont_dev_t *dev)
+{
+    return sim_of(dev)->cycles();
+}
+
+int vl_irq_enable(mont_dev_t *)
+{
+    return 1;
+}
+
+// clock the model until irq goes high; timeout_ms is taken at 100 MHz
+int vl_irq_wait(mont_dev_t *dev, u32 timeout_ms)
+{
+    MontAxiSim *sim   = sim_of(dev);
+    uint64_t    limit = 100000ULL * timeout_ms;
+
+    for (uint64_t n = 0; n < limit; ++n) {
+        if (sim->irq())
+            return 1;
+        sim->idle(1);
+    }
+    return 0;
+}
+
+void *vl_dma_alloc(mont_dev_t *dev, u32 bytes, u32 *phys)
+{
+    return sim_of(dev)->dma_alloc(bytes, phys);
+}
+
+const mont_hal_ops_t vl_ops = {
+    vl_write_block,
+    vl_read_block,
+    vl_write_reg,
+    vl_read_reg,
+    mont_hal_poll_done,
+    vl_close,
+    vl_cycles,
+    vl_irq_enable,
+    vl_irq_wait,
+    vl_dma_alloc,
+    nullptr
+};
+
+} // namespace
+
+extern "C" int mont_hal_verilator_open(mont_dev_t *dev, u32 nwords)
+{
+    MontAxiSim *sim;
+
+    if (nwords == NWORDS_2048) {
+        sim = new MontAxiSimImpl<Vmontgomery_axi>();
+    } else if (nwords == NWORDS_1024) {
+        sim = new MontAxiSimImpl<Vmontgomery_axi_1024>();
+    } else {
+        xil_printf("[ERROR] No Verilated montgomery_axi with %u words\r\n",
+                   (unsigned)nwords);
+        return 0;
+    }
+
+    dev->ops     = &vl_ops;
+    dev->backend = "verilator";
+    dev->nwords  = nwords;
+    dev->base    = 0U;
+    dev->regs    = nullptr;
+    dev->priv    = sim;
+    return 1;
+}
@@ -0,0 +1,32 @@
+#!/bin/sh
+# -----------------------------------------------------------------------------
+# sweep_clk.sh
+# Build montgomery_axi with CORE_CLK_ASYNC = 1 and run the benchmark with the
+# core clock at several frequencies against a 100 MHz s_axi_aclk. Every run
+# compares all HW results with SW; per point this prints the OK / FAIL
+# counts and the clocks per Montgomery product in s_axi clocks:
+#   sim/sweep_clk.sh            (default: 100 150 200 250 60 MHz)
+#   sim/sweep_clk.sh 133 300
+# The core variant comes from $CORE_TYPE (default 4, the word-serial core).
+# -----------------------------------------------------------------------------
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+MHZ=${*:-"100 150 200 250 60"}
+CORE=${CORE_TYPE:-4}
+OUT="$ROOT/sim/obj_dir/clk"
+
+OUT="$OUT" BIN="$OUT/rsa_bench_sim" \
+VFLAGS_EXTRA="-GCORE_TYPE=$CORE -GCORE_CLK_ASYNC=1" CFLAGS_EXTRA="-DNUM_RUNS=1" \
+    "$ROOT/sim/build.sh" > "$ROOT/sim/obj_dir/clk.log" 2>&1
+
+for F in $MHZ; do
+    MONT_BACKEND=verilator MONT_AXI_PS=10000 MONT_CORE_PS=$((1000000 / F)) \
+        "$OUT/rsa_bench_sim" |
+        awk -v f="$F" '/key size: 2048/ { k = 2048 } /key size: 1024/ { k = 1024 }
+                       /HW core:/       { c[k] = $3 }
+                       /: OK/           { ok++ }
+                       /: FAIL/         { bad++ }
+                       END { printf "core %4s MHz: %3d OK %3d FAIL   2048: %6s  1024: %6s s_axi clocks/product\n",
+                                    f, ok, bad, c[2048], c[1024] }'
+done
@@ -0,0 +1,28 @@
+#!/bin/sh
+# -----------------------------------------------------------------------------
+# sweep_lanes.sh
+# Build montgomery_axi with 1, 2, 4 ... lanes and print the descriptor ring
+# throughput of each: accelerator clocks per product and products per second
+# at a 100 MHz fabric clock (the simulated DDR is the same for every point):
+#   sim/sweep_lanes.sh          (default: 1 2 4)
+#   sim/sweep_lanes.sh 1 2 3 4
+# The core variant comes from $CORE_TYPE (default 4, the word-serial core).
+# -----------------------------------------------------------------------------
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+LANES=${*:-"1 2 4"}
+CORE=${CORE_TYPE:-4}
+
+for L in $LANES; do
+    OUT="$ROOT/sim/obj_dir/lanes$L" BIN="$ROOT/sim/obj_dir/lanes$L/rsa_bench_sim" \
+    VFLAGS_EXTRA="-GCORE_TYPE=$CORE -GNUM_LANES=$L" CFLAGS_EXTRA="-DNUM_RUNS=1" \
+        "$ROOT/sim/build.sh" > "$ROOT/sim/obj_dir/lanes$L.log" 2>&1
+
+    MONT_BACKEND=verilator "$ROOT/sim/obj_dir/lanes$L/rsa_bench_sim" |
+        awk -v l="$L" '/^\[DMA\].*2048/ { k = 2048 } /^\[DMA\].*1024/ { k = 1024 }
+                       /accelerator clocks\/product/ { c[k] = $3 }
+                       END { printf "NUM_LANES=%-2s 2048: %7s clk %8.0f/s   1024: %7s clk %8.0f/s\n",
+                                    l, c[2048], (c[2048] ? 1e8 / c[2048] : 0),
+                                       c[1024], (c[1024] ? 1e8 / c[1024] : 0) }'
+done
@@ -0,0 +1,25 @@
+#!/bin/sh
+# -----------------------------------------------------------------------------
+# sweep_pe.sh
+# Build the systolic core (CORE_TYPE = 5) for each NUM_PE and print the core
+# clocks per Montgomery product read back from the CYCLES register:
+#   sim/sweep_pe.sh            (default: 1 2 4 8 16 32 64)
+#   sim/sweep_pe.sh 8 16 32
+# Area for the same points comes from syn/util_sweep.tcl.
+# -----------------------------------------------------------------------------
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+PES=${*:-"1 2 4 8 16 32 64"}
+
+for P in $PES; do
+    OUT="$ROOT/sim/obj_dir/pe$P" BIN="$ROOT/sim/obj_dir/pe$P/rsa_bench_sim" \
+    VFLAGS_EXTRA="-GCORE_TYPE=5 -GNUM_PE=$P" CFLAGS_EXTRA="-DNUM_RUNS=1" \
+        "$ROOT/sim/build.sh" > "$ROOT/sim/obj_dir/pe$P.log" 2>&1
+
+    MONT_BACKEND=verilator "$ROOT/sim/obj_dir/pe$P/rsa_bench_sim" |
+        awk -v p="$P" '/key size: 2048/ { k = 2048 } /key size: 1024/ { k = 1024 }
+                       /HW core:/       { c[k] = $3 }
+                       END { printf "NUM_PE=%-3s 2048: %6s  1024: %6s clocks\n",
+                                    p, c[2048], c[1024] }'
+done
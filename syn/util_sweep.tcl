@@ -0,0 +1,51 @@
+# -----------------------------------------------------------------------------
+# util_sweep.tcl
+# Out-of-context synthesis of montgomery_axi with the systolic core for a
+# range of NUM_PE values; writes one utilization/timing report per point.
+#
+#   vivado -mode batch -source syn/util_sweep.tcl -tclargs 2048 1 2 4 8 16 32 64
+#
+# First argument is N_BITS, the rest are NUM_PE values. Part defaults to the
+# Zybo/PYNQ xc7z020; override with $env(MONT_PART). $env(MONT_CORE) and
+# $env(MONT_LANES) set CORE_TYPE (default 5) and NUM_LANES (default 1);
+# $env(MONT_CORE_PS) builds CORE_CLK_ASYNC = 1 with core_clk at that period.
+# -----------------------------------------------------------------------------
+set root   [file normalize [file join [file dirname [info script]] ..]]
+set part   [expr {[info exists env(MONT_PART)] ? $env(MONT_PART) : "xc7z020clg400-1"}]
+set n_bits [expr {$argc > 0 ? [lindex $argv 0] : 2048}]
+set pes    [expr {$argc > 1 ? [lrange $argv 1 end] : {1 2 4 8 16 32 64}}]
+set core   [expr {[info exists env(MONT_CORE)]  ? $env(MONT_CORE)  : 5}]
+set lanes  [expr {[info exists env(MONT_LANES)] ? $env(MONT_LANES) : 1}]
+set core_ps [expr {[info exists env(MONT_CORE_PS)] ? $env(MONT_CORE_PS) : 0}]
+set async  [expr {$core_ps > 0 ? 1 : 0}]
+
+set rtl [list montgomery_axi.v montgomery_lane.v montgomery_dma.v montgomery_mul.v \
+              montgomery_mul_1cyc.v montgomery_mul_csa.v montgomery_mul_r4.v \
+              montgomery_mul_word.v montgomery_mul_systolic.v montgomery_mul_systolic_pe.v]
+
+file mkdir [file join $root syn reports]
+
+foreach p $pes {
+    close_project -quiet
+    create_project -in_memory -part $part
+    foreach f $rtl { read_verilog [file join $root $f] }
+
+    synth_design -top montgomery_axi -mode out_of_context -part $part \
+        -generic N_BITS=$n_bits -generic CORE_TYPE=$core -generic NUM_PE=$p \
+        -generic NUM_LANES=$lanes -generic CORE_CLK_ASYNC=$async
+
+    create_clock -period 10.000 -name s_axi_aclk [get_ports s_axi_aclk]
+
+    set tag "n${n_bits}_c${core}_l${lanes}_pe${p}"
+    if {$async} {
+        # start / done cross through synchronizers, the buses they qualify
+        # are held for at least two destination clocks
+        set core_ns [expr {$core_ps / 1000.0}]
+        create_clock -period $core_ns -name core_clk [get_ports core_clk]
+        set_max_delay -datapath_only $core_ns -from [get_clocks s_axi_aclk] -to [get_clocks core_clk]
+        set_max_delay -datapath_only 10.000   -from [get_clocks core_clk] -to [get_clocks s_axi_aclk]
+        append tag "_core${core_ps}ps"
+    }
+    report_utilization    -file [file join $root syn reports util_$tag.rpt]
+    report_timing_summary -file [file join $root syn reports timing_$tag.rpt]
+}